@@ -1,141 +1,214 @@
 #include "Board.h"
-#include <iostream>
 #include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
 #include <random>
 #include <unistd.h>
 #include <termios.h>
 
 using namespace std;
 
-Board::Board() : player(margin + 2, height / 2), 
-              townhall(80, height / 2),
-              leftTexts(height - 2, string(margin - 1, ' ')),
-              spawnCounter(0),
+// Enemies only fight inside this distance of the town hall, which bounds the flow field and the
+// enemy update however large the world is.
+static const int BATTLEFIELD_RADIUS_X = 128;
+static const int BATTLEFIELD_RADIUS_Y = 64;
+
+Board::Board() : Board(114, 31, random_device()()) {}
+
+Board::Board(int width, int height, unsigned seed, int viewWidth, int viewHeight)
+            : width(width), height(height),
+              player(0, height / 2),
+              townhall(width / 2 - 9, height / 2),
+              enemies(timers),
+              nextSpawn(30),
               spawnRate(30),
-              gameOver(false) {}
-
-void Board::drawBuilding(const Building& building) const {
-    int startX = building.getPosition().x;
-    int startY = building.getPosition().y;
-    string icon = building.getIcon();
-
-    if (building.Border()) {
-        int sizeX = building.getSizeX();
-        int sizeY = building.getSizeY();
-
-        cout << "\033[" << startY << ";" << startX << "H┌";
-        for (int i = 0; i < sizeX - 2; ++i) cout << "─";
-        cout << "┐";
-
-        for (int j = 1; j < sizeY - 1; ++j) {
-            cout << "\033[" << startY + j << ";" << startX << "H│";
-            for (int i = 1; i < sizeX - 1; ++i) {
-                if (i == sizeX/2 && j == sizeY/2) {
-                    cout << icon;
-                    if (i < sizeX - 2) ++i;
-                } else {
-                    cout << " ";
-                }
-            }
-            cout << "│";
-        }
+              gameOver(false),
+              tick(0),
+              seed(seed),
+              rng(seed),
+              fieldLeft(max(0, width / 2 - 5 - BATTLEFIELD_RADIUS_X)),
+              fieldTop(max(0, height / 2 + 2 - BATTLEFIELD_RADIUS_Y)),
+              fieldRight(min(width - 1, width / 2 - 5 + BATTLEFIELD_RADIUS_X)),
+              fieldBottom(min(height - 1, height / 2 + 2 + BATTLEFIELD_RADIUS_Y)),
+              hasAnchor(false),
+              anchor(0, 0),
+              occupancy(width, height),
+              flowField(fieldLeft, fieldTop, fieldRight, fieldBottom, getEnemyArchetype(GRUNT).damage),
+              view(width, height, viewWidth, viewHeight) {
+    walls.reserve(Wall::getMaxInstances());
+    goldMines.reserve(GoldMine::getMaxInstances());
+    elixirCollectors.reserve(ElixirCollector::getMaxInstances());
+    occupancy.place(&townhall);
+    flowField.rebuild(occupancy);
+    timers.schedule(nextSpawn, TIMER_SPAWN, 0);
+}
 
-        cout << "\033[" << startY + sizeY - 1 << ";" << startX << "H└";
-        for (int i = 0; i < sizeX - 2; ++i) cout << "─";
-        cout << "┘";
-    } else {
-        cout << "\033[" << startY << ";" << startX << "H" << icon;
-    }
+template <typename T>
+void Board::drawBuilding(const T& building, GlyphId icon) {
+    view.drawBuilding(building.getPosition(), T::getSizeX(), T::getSizeY(), T::Border(), icon);
 }
 
-bool Board::areBuildingsColliding(const Building& b1, const Building& b2) const {
-    int x1_min = b1.getPosition().x;
-    int y1_min = b1.getPosition().y;
-    int x1_max = x1_min + b1.getSizeX();
-    int y1_max = y1_min + b1.getSizeY();
+int Board::getWidth() const { return width; }
+int Board::getHeight() const { return height; }
+int Board::getFieldLeft() const { return fieldLeft; }
+int Board::getFieldTop() const { return fieldTop; }
+int Board::getFieldRight() const { return fieldRight; }
+int Board::getFieldBottom() const { return fieldBottom; }
+bool Board::isGameOver() const { return gameOver; }
+long long Board::getTick() const { return tick; }
+unsigned Board::getSeed() const { return seed; }
+
+static void mix(unsigned long long& hash, long long value) {
+    for (int i = 0; i < 8; ++i) {
+        hash ^= (value >> (i * 8)) & 0xff;
+        hash *= 1099511628211ULL;
+    }
+}
 
-    int x2_min = b2.getPosition().x;
-    int y2_min = b2.getPosition().y;
-    int x2_max = x2_min + b2.getSizeX();
-    int y2_max = y2_min + b2.getSizeY();
+static void mixBuilding(unsigned long long& hash, const Building& building) {
+    mix(hash, building.getPosition().x);
+    mix(hash, building.getPosition().y);
+    mix(hash, building.getHealth());
+}
 
-    bool noOverlap = x1_max <= x2_min || x2_max <= x1_min ||
-                     y1_max <= y2_min || y2_max <= y1_min;
+// FNV-1a over everything the simulation evolves; replays compare it to prove they ran bit-for-bit.
+unsigned long long Board::checksum() const {
+    unsigned long long hash = 14695981039346656037ULL;
+    mix(hash, tick);
+    mix(hash, nextSpawn);
+    mix(hash, hasAnchor);
+    mix(hash, anchor.x);
+    mix(hash, anchor.y);
+    mix(hash, gameOver);
+    mix(hash, player.getPosition().x);
+    mix(hash, player.getPosition().y);
+    mix(hash, player.getResources().gold);
+    mix(hash, player.getResources().elixir);
+    mixBuilding(hash, townhall);
+    for (const auto& wall : walls) mixBuilding(hash, wall);
+    for (const auto& mine : goldMines) {
+        mixBuilding(hash, mine);
+        mix(hash, mine.getCurrentAmount(tick));
+    }
+    for (const auto& collector : elixirCollectors) {
+        mixBuilding(hash, collector);
+        mix(hash, collector.getCurrentAmount(tick));
+    }
+    for (size_t i = 0; i < enemies.slotCount(); ++i) {
+        mix(hash, enemies.isAlive(i));
+        if (!enemies.isAlive(i)) continue;
+        mix(hash, enemies.getX(i));
+        mix(hash, enemies.getY(i));
+        mix(hash, enemies.getHealth(i));
+        mix(hash, enemies.getState(i));
+    }
+    return hash;
+}
 
-    return !noOverlap;
+string Board::describeState() const {
+    ostringstream out;
+    out << "gold=" << player.getResources().gold
+        << " elixir=" << player.getResources().elixir
+        << " walls=" << walls.size()
+        << " goldMines=" << goldMines.size()
+        << " elixirCollectors=" << elixirCollectors.size()
+        << " townHallHP=" << townhall.getHealth()
+        << " enemies=" << enemies.size()
+        << " chunks=" << occupancy.getAllocatedChunks()
+        << " gameOver=" << (gameOver ? "yes" : "no");
+    return out.str();
 }
 
 bool Board::isPositionOccupied(const Position& pos, const Building* ignore) const {
-    for (const auto& wall : walls) {
-        if (ignore != &wall &&
-            areBuildingsColliding(Building(pos.x, pos.y, 1, 1, 0, 0, 0, 0, "", false), wall)) {
-            return true;
-        }
-    }
-    return false;
+    const Building* building = occupancy.at(pos.x, pos.y);
+    return building && building != ignore && building->getType() == WALL;
 }
 
-bool Board::CanBuild(const Building* building, const Building* ignore) const {
-    for (const auto& wall : walls) {
-        if (ignore != &wall && areBuildingsColliding(*building, wall)) return false;
-    }
-    for (const auto& mine : goldMines) {
-        if (ignore != &mine && areBuildingsColliding(*building, mine)) return false;
-    }
-    for (const auto& collector : elixirCollectors) {
-        if (ignore != &collector && areBuildingsColliding(*building, collector)) return false;
+template <typename T>
+static void repairFootprint(FlowField& flowField, const OccupancyGrid& occupancy, const T& building) {
+    Position pos = building.getPosition();
+    flowField.repair(occupancy, pos.x, pos.y, T::getSizeX(), T::getSizeY());
+}
+
+// Handles outlive a reallocation, but the registry has to learn where every element moved to.
+template <typename T>
+static T& appendBuilding(vector<T>& buildings, const T& building, OccupancyGrid& occupancy) {
+    const T* before = buildings.data();
+    buildings.push_back(building);
+    if (buildings.data() != before) {
+        for (size_t i = 0; i + 1 < buildings.size(); ++i) occupancy.relocate(&buildings[i]);
     }
-    if (areBuildingsColliding(*building, townhall)) return false;
+    occupancy.place(&buildings.back());
+    return buildings.back();
+}
 
-    return true;
+template <typename T>
+static void removeDestroyed(vector<T>& buildings, OccupancyGrid& occupancy, FlowField& flowField) {
+    size_t kept = 0;
+    for (size_t i = 0; i < buildings.size(); ++i) {
+        if (buildings[i].getHealth() <= 0) {
+            occupancy.remove(&buildings[i]);
+            repairFootprint(flowField, occupancy, buildings[i]);
+            continue;
+        }
+        if (kept != i) {
+            buildings[kept] = buildings[i];
+            occupancy.relocate(&buildings[kept]);
+        }
+        ++kept;
+    }
+    buildings.erase(buildings.begin() + kept, buildings.end());
 }
 
 void Board::spawnEnemy() {
-    spawnCounter++;
-    if (spawnCounter >= spawnRate) {
-        spawnCounter = 0;
-        
-        static random_device rd;
-        static mt19937 gen(rd());
-        uniform_int_distribution<> dis(0, 1);
-        
-        int x, y;
-        uniform_int_distribution<> y_dis(1, height - 2);
-        y = y_dis(gen);
-        
-        if (dis(gen)) {
-            x = margin + 1;
-        } else {
-            x = width - 2;
-        }
-        
-        enemies.emplace_back(x, y);
+    nextSpawn = tick + spawnRate;
+    timers.schedule(nextSpawn, TIMER_SPAWN, 0);
+
+    uniform_int_distribution<> dis(0, 1);
+    
+    int x, y;
+    uniform_int_distribution<> y_dis(fieldTop, fieldBottom);
+    y = y_dis(rng);
+    
+    if (dis(rng)) {
+        x = fieldLeft;
+    } else {
+        x = fieldRight;
     }
+    
+    spawnEnemyAt(x, y);
+}
+
+void Board::spawnEnemyAt(int x, int y) {
+    enemies.spawn(x, y);
+}
+
+bool Board::addWall(int x, int y) {
+    Wall newWall(x, y);
+    if (!CanBuild(newWall)) return false;
+    repairFootprint(flowField, occupancy, appendBuilding(walls, newWall, occupancy));
+    return true;
 }
 
 void Board::updateEnemies() {
-    for (auto& enemy : enemies) {
-        if (enemy.update(townhall.getPosition(), walls, goldMines, elixirCollectors, townhall)) {
-            gameOver = true;
-            return;  // No need to continue; game is over
-        }
+    if (enemies.update(firedTimers, flowField, occupancy)) {
+        gameOver = true;
+        return;  // No need to continue; game is over
     }
 
-    walls.erase(remove_if(walls.begin(), walls.end(), 
-        [](const Wall& w) { return w.getHealth() <= 0; }), walls.end());
-    goldMines.erase(remove_if(goldMines.begin(), goldMines.end(), 
-        [](const GoldMine& m) { return m.getHealth() <= 0; }), goldMines.end());
-    elixirCollectors.erase(remove_if(elixirCollectors.begin(), elixirCollectors.end(), 
-        [](const ElixirCollector& e) { return e.getHealth() <= 0; }), elixirCollectors.end());
+    removeDestroyed(walls, occupancy, flowField);
+    removeDestroyed(goldMines, occupancy, flowField);
+    removeDestroyed(elixirCollectors, occupancy, flowField);
 }
 
 bool Board::tryMovePlayer(char direction) {
     Position newPos = player.getPosition();
     switch(direction) {
-        case 'U': if (newPos.y > 1) newPos.y--; break;
-        case 'D': if (newPos.y < height - 2) newPos.y++; break;
-        case 'L': if (newPos.x > margin + 2) newPos.x -= 2; break;
-        case 'R': if (newPos.x < width - 4) newPos.x += 2; break;
+        case 'U': if (newPos.y > 0) newPos.y--; break;
+        case 'D': if (newPos.y < height - 1) newPos.y++; break;
+        case 'L': if (newPos.x >= 2) newPos.x -= 2; break;
+        case 'R': if (newPos.x + 2 <= width - 2) newPos.x += 2; break;
         default: return false;
     }
     if (!isPositionOccupied(newPos)) {
@@ -145,175 +218,284 @@ bool Board::tryMovePlayer(char direction) {
     return false;
 }
 
+// Places every wall in wallCells or none of them: the cap, the cost and every cell are checked
+// first, then the walls go in together and the flow field is repaired once over their bounds.
+bool Board::placeWalls() {
+    int count = wallCells.size();
+    if (count == 0 || (int)walls.size() + count > Wall::getMaxInstances()) return false;
+    if (player.getResources().gold < count * Wall::getCostGold() ||
+        player.getResources().elixir < count * Wall::getCostElixir()) return false;
+
+    int left = width, top = height, right = -1, bottom = -1;
+    for (const Position& cell : wallCells) {
+        if (cell.x < 0 || cell.y < 0 || cell.x >= width || cell.y >= height) return false;
+        if (occupancy.at(cell.x, cell.y)) return false;
+        left = min(left, cell.x);
+        top = min(top, cell.y);
+        right = max(right, cell.x);
+        bottom = max(bottom, cell.y);
+    }
+
+    player.getResources().spendGold(count * Wall::getCostGold());
+    player.getResources().spendElixir(count * Wall::getCostElixir());
+    for (const Position& cell : wallCells) appendBuilding(walls, Wall(cell.x, cell.y), occupancy);
+    flowField.repair(occupancy, left, top, right - left + 1, bottom - top + 1);
+    return true;
+}
+
 bool Board::placeWall() {
-    Position pos = player.getPosition();
-    Wall newWall(pos.x, pos.y);
+    wallCells.clear();
+    wallCells.push_back(player.getPosition());
+    return placeWalls();
+}
 
-    if (!CanBuild(&newWall)) return false;
-    if (walls.size() >= newWall.getMaxInstances()) return false;
+bool Board::setWallAnchor() {
+    anchor = player.getPosition();
+    hasAnchor = true;
+    return true;
+}
 
-    if (player.getResources().gold >= newWall.getCostGold() && player.getResources().elixir >= newWall.getCostElixir()) {
-        player.getResources().spendGold(newWall.getCostGold());
-        player.getResources().spendElixir(newWall.getCostElixir());
-        walls.push_back(newWall);
-        return true;
+// Walls sit on the even columns the player walks, so the line is traced in (x / 2, y) space.
+bool Board::placeWallLine() {
+    if (!hasAnchor) return false;
+    int x0 = anchor.x / 2, y0 = anchor.y;
+    int x1 = player.getPosition().x / 2, y1 = player.getPosition().y;
+    int dx = abs(x1 - x0), dy = -abs(y1 - y0);
+    int stepX = x0 < x1 ? 1 : -1, stepY = y0 < y1 ? 1 : -1;
+    int error = dx + dy;
+
+    wallCells.clear();
+    while (true) {
+        wallCells.push_back(Position(x0 * 2, y0));
+        if (x0 == x1 && y0 == y1) break;
+        int doubled = 2 * error;
+        if (doubled >= dy) { error += dy; x0 += stepX; }
+        if (doubled <= dx) { error += dx; y0 += stepY; }
     }
+    if (!placeWalls()) return false;
+    hasAnchor = false;
+    return true;
+}
 
-    return false;
+bool Board::placeWallRectangle() {
+    if (!hasAnchor) return false;
+    const Position& pos = player.getPosition();
+    int left = min(anchor.x, pos.x), right = max(anchor.x, pos.x);
+    int top = min(anchor.y, pos.y), bottom = max(anchor.y, pos.y);
+
+    wallCells.clear();
+    for (int x = left; x <= right; x += 2) {
+        wallCells.push_back(Position(x, top));
+        if (bottom != top) wallCells.push_back(Position(x, bottom));
+    }
+    for (int y = top + 1; y < bottom; ++y) {
+        wallCells.push_back(Position(left, y));
+        if (right != left) wallCells.push_back(Position(right, y));
+    }
+    if (!placeWalls()) return false;
+    hasAnchor = false;
+    return true;
 }
 
-bool Board::placeGoldMine() {
+// Centres a building on the player and pays for it. Footprint, cap and costs all come from T's
+// traits, so one definition serves every building placed this way.
+template <typename T>
+bool Board::placeCentered(vector<T>& buildings) {
     Position pos = player.getPosition();
-    GoldMine newMine(0, 0);
-    int centerX = pos.x - newMine.getSizeX() / 2;
-    int centerY = pos.y - newMine.getSizeY() / 2;
-    GoldMine mineToPlace(centerX, centerY);
+    T building(pos.x - T::getSizeX() / 2, pos.y - T::getSizeY() / 2, tick);
 
-    if (!CanBuild(&mineToPlace)) return false;
-    if (goldMines.size() >= newMine.getMaxInstances()) return false;
+    if (!CanBuild(building)) return false;
+    if ((int)buildings.size() >= T::getMaxInstances()) return false;
 
-    if (player.getResources().elixir >= newMine.getCostElixir()) {
-        player.getResources().spendElixir(newMine.getCostElixir());
-        goldMines.push_back(mineToPlace);
-        return true;
-    }
+    Resources& resources = player.getResources();
+    if (resources.gold < T::getCostGold() || resources.elixir < T::getCostElixir()) return false;
+    resources.spendGold(T::getCostGold());
+    resources.spendElixir(T::getCostElixir());
+    repairFootprint(flowField, occupancy, appendBuilding(buildings, building, occupancy));
+    return true;
+}
 
-    return false;
+bool Board::placeGoldMine() {
+    return placeCentered(goldMines);
 }
 
 bool Board::placeElixirCollector() {
+    return placeCentered(elixirCollectors);
+}
+
+// Enemies are drawn two columns wide, so the reach spans two columns either side of the player.
+int Board::attackNearby() {
     Position pos = player.getPosition();
-    ElixirCollector newCollector(0, 0);
-    int centerX = pos.x - newCollector.getSizeX() / 2;
-    int centerY = pos.y - newCollector.getSizeY() / 2;
-    ElixirCollector collectorToPlace(centerX, centerY);
+    return enemies.damageArea(pos.x - 2, pos.y - 1, pos.x + 2, pos.y + 1, player.getDamage());
+}
 
-    if (!CanBuild(&collectorToPlace)) return false;
-    if (elixirCollectors.size() >= newCollector.getMaxInstances()) return false;
+// Every cell belongs to at most one building, so the generator under the player is found through
+// the occupancy grid instead of a scan over every generator.
+void Board::collectResources() {
+    Position pos = player.getPosition();
+    Building* building = occupancy.at(pos.x, pos.y);
+    if (!building) return;
 
-    if (player.getResources().gold >= newCollector.getCostGold()) {
-        player.getResources().spendGold(newCollector.getCostGold());
-        elixirCollectors.push_back(collectorToPlace);
-        return true;
+    if (building->getType() == GOLD_MINE) {
+        player.getResources().gold += static_cast<GoldMine*>(building)->collect(tick);
+    } else if (building->getType() == ELIXIR_COLLECTOR) {
+        player.getResources().elixir += static_cast<ElixirCollector*>(building)->collect(tick);
     }
+}
 
+bool Board::applyCommand(char command) {
+    switch(command) {
+        case 'U': case 'D': case 'L': case 'R':
+            return tryMovePlayer(command);
+        case 'W':
+            return placeWall();
+        case 'B':
+            return setWallAnchor();
+        case 'J':
+            return placeWallLine();
+        case 'K':
+            return placeWallRectangle();
+        case 'M':
+            return placeGoldMine();
+        case 'E':
+            return placeElixirCollector();
+        case 'C':
+            collectResources();
+            return true;
+        case 'A':
+            return attackNearby() > 0;
+    }
     return false;
 }
 
-void Board::collectResources() {
-    Position pos = player.getPosition();
+void Board::update() {
+    if (gameOver) return;
+    ScopedTimer tickTimer(perf.get(), PERF_TICK);
+    TraceSpan tickSpan("Board::update");
+    ++tick;
+    firedTimers.clear();
+    timers.advance(firedTimers);
+    for (const auto& timer : firedTimers) {
+        if (timer.channel != TIMER_SPAWN) continue;
+        ScopedTimer spawnTimer(perf.get(), PERF_SPAWN);
+        TraceSpan spawnSpan("spawnEnemy");
+        spawnEnemy();
+    }
+    ScopedTimer enemyTimer(perf.get(), PERF_ENEMIES);
+    TraceSpan enemySpan("updateEnemies");
+    updateEnemies();
+}
 
-    for (auto& mine : goldMines) {
-        Position bPos = mine.getPosition();
-        if (pos.x >= bPos.x && pos.x < bPos.x + mine.getSizeX() &&
-            pos.y >= bPos.y && pos.y < bPos.y + mine.getSizeY()) {
-            int collected = mine.collect();
-            if (collected > 0) {
-                player.getResources().gold += collected;
-                break;
-            }
+void Board::draw() {
+    view.begin(player.getPosition());
+    PanelStatus status = { player.getResources().gold, player.getResources().elixir,
+                           walls.size(), goldMines.size(), elixirCollectors.size(),
+                           townhall.getHealth(), enemies.size(), player.getPosition() };
+    view.drawPanel(status);
+
+    // Only buildings in the occupancy chunks under the camera are visited, however large the world.
+    // Two-column icons can spill onto a neighbour's cell, so they are drawn in type order as before.
+    int left, top, right, bottom;
+    view.getVisibleArea(left, top, right, bottom);
+    {
+        TraceSpan span("draw buildings");
+        for (auto& bucket : visibleBuildings) bucket.clear();
+        occupancy.forEachBuildingIn(left, top, right, bottom, [&](Building* building) {
+            visibleBuildings[building->getType()].push_back(building);
+        });
+        for (Building* building : visibleBuildings[TOWN_HALL]) {
+            drawBuilding(*static_cast<TownHall*>(building), TownHall::getIcon());
+        }
+        for (Building* building : visibleBuildings[WALL]) {
+            drawBuilding(*static_cast<Wall*>(building), Wall::getIcon());
+        }
+        for (Building* building : visibleBuildings[GOLD_MINE]) {
+            const GoldMine& mine = *static_cast<GoldMine*>(building);
+            drawBuilding(mine, mine.getIconAt(tick));
+        }
+        for (Building* building : visibleBuildings[ELIXIR_COLLECTOR]) {
+            const ElixirCollector& collector = *static_cast<ElixirCollector*>(building);
+            drawBuilding(collector, collector.getIconAt(tick));
         }
     }
+    if (hasAnchor) view.put(anchor.x, anchor.y, '+');
 
-    for (auto& collector : elixirCollectors) {
-        Position bPos = collector.getPosition();
-        if (pos.x >= bPos.x && pos.x < bPos.x + collector.getSizeX() &&
-            pos.y >= bPos.y && pos.y < bPos.y + collector.getSizeY()) {
-            int collected = collector.collect();
-            if (collected > 0) {
-                player.getResources().elixir += collected;
-                break;
-            }
-        }
+    for (size_t i = 0; i < enemies.slotCount(); ++i) {
+        if (!enemies.isAlive(i)) continue;
+        int x = enemies.getX(i), y = enemies.getY(i);
+        if (x < left || x > right || y < top || y > bottom) continue;
+        view.put(x, y, enemies.getArchetype(i).icon);
     }
-}
 
-void Board::updateResources() {
-    for (auto& mine : goldMines) mine.update();
-    for (auto& collector : elixirCollectors) collector.update();
-}
+    view.put(player.getPosition().x, player.getPosition().y, player.getIcon());
 
-void Board::update() {
-    if (gameOver) return;
-    spawnEnemy();
-    updateEnemies();
-    updateResources();
+    if (gameOver) view.showMessage("GAME OVER - Town Hall Destroyed!");
+    if (perf) renderPerf();
 }
 
 void Board::render() {
-    system("clear");
-    renderTopBorder();
-    renderMiddle();
-    renderBottomBorder();
-
-    drawBuilding(townhall);
-    for (const auto& wall : walls) drawBuilding(wall);
-    for (const auto& mine : goldMines) drawBuilding(mine);
-    for (const auto& collector : elixirCollectors) drawBuilding(collector);
-
-    for (const auto& enemy : enemies) {
-        cout << "\033[" << enemy.getPosition().y << ";" << enemy.getPosition().x << "H";
-        cout << enemy.getIcon();
+    TraceSpan renderSpan("render");
+    {
+        ScopedTimer drawTimer(perf.get(), PERF_DRAW);
+        TraceSpan drawSpan("draw");
+        draw();
     }
+    ScopedTimer presentTimer(perf.get(), PERF_PRESENT);
+    TraceSpan presentSpan("present");
+    view.present();
+}
 
-    cout << "\033[" << player.getPosition().y << ";" << player.getPosition().x << "H";
-    cout << player.getIcon();
+static string formatMicros(long long nanos) {
+    ostringstream out;
+    out << fixed << setprecision(1) << nanos / 1000.0;
+    return out.str();
+}
 
-    if (gameOver) {
-        string message = "GAME OVER - Town Hall Destroyed!";
-        cout << "\033[" << height/2 << ";" << (width - message.length())/2 << "H";
-        cout << message;
-        cout << "\033[" << height << ";0H";
-        exit(0);
+// Fills the panel rows below the status block, leaving one blank row between them. Timings are
+// microseconds, and the frame figures describe the previous frame, the last one written out.
+// A terminal too short for the whole panel gets a note saying so instead of a clipped panel.
+void Board::renderPerf() {
+    size_t buildings = 1 + walls.size() + goldMines.size() + elixirCollectors.size();
+    string lines[] = {
+        "Tick = " + formatMicros(perf->getLast(PERF_TICK)) + " us",
+        "p50/p99 = " + formatMicros(perf->getTickPercentile(50)) + "/" + formatMicros(perf->getTickPercentile(99)),
+        "Spawn = " + formatMicros(perf->getLast(PERF_SPAWN)) + " us",
+        "Enemy update = " + formatMicros(perf->getLast(PERF_ENEMIES)) + " us",
+        "Draw = " + formatMicros(perf->getLast(PERF_DRAW)) + " us",
+        "Present = " + formatMicros(perf->getLast(PERF_PRESENT)) + " us",
+        "Frame = " + to_string(view.getFrameBytes()) + " B, " + to_string(view.getFrameWrites()) + " writes",
+        "Enemies = " + to_string(enemies.size()) + "/" + to_string(enemies.slotCount()) + " slots",
+        "Buildings = " + to_string(buildings),
+        "RSS = " + to_string(perf->getResidentBytes() / 1024) + " KiB"
+    };
+    int count = sizeof(lines) / sizeof(lines[0]);
+    int first = WorldView::PANEL_STATUS_ROWS + 2;
+    int freeRows = view.getPanelRows() - first + 1;
+    if (freeRows < count) {
+        view.setPanelLine(first, "Perf needs " + to_string(count - freeRows) + " more rows");
+        return;
     }
+    for (int i = 0; i < count; ++i) view.setPanelLine(first + i, lines[i]);
 }
 
-void Board::renderTopBorder() const {
-    cout << "╔";
-    for (int x = 1; x < width - 1; x++) {
-        cout << (x == margin ? "╦" : "═");
-    }
-    cout << "╗" << endl;
+void Board::invalidateScreen() {
+    view.invalidate();
 }
 
-void Board::renderBottomBorder() const {
-    cout << "╚";
-    for (int x = 1; x < width - 1; x++) {
-        cout << (x == margin ? "╩" : "═");
-    }
-    cout << "╝" << endl;
-}
-
-void Board::renderMiddle() const {
-    for (int y = 1; y < height - 1; y++) {
-        cout << "║";
-
-        if (y == 1) {
-            string line = "Gold = " + to_string(player.getResources().gold);
-            cout << line << string(margin - 1 - line.length(), ' ');
-        } else if (y == 2) {
-            string line = "Elixir = " + to_string(player.getResources().elixir);
-            cout << line << string(margin - 1 - line.length(), ' ');
-        } else if (y == 3) {
-            string line = "Walls = " + to_string(walls.size()) + "/200";
-            cout << line << string(margin - 1 - line.length(), ' ');
-        } else if (y == 4) {
-            string line = "Gold Mines = " + to_string(goldMines.size()) + "/3";
-            cout << line << string(margin - 1 - line.length(), ' ');
-        } else if (y == 5) {
-            string line = "Elixir Generators = " + to_string(elixirCollectors.size()) + "/3";
-            cout << line << string(margin - 1 - line.length(), ' ');
-        } else if (y == 6) {
-            string line = "Town Hall HP = " + to_string(townhall.getHealth());
-            cout << line << string(margin - 1 - line.length(), ' ');
-        } else if (y == 7) {
-            string line = "Enemies = " + to_string(enemies.size());
-            cout << line << string(margin - 1 - line.length(), ' ');
-        } else {
-            cout << string(margin - 1, ' ');
-        }
+void Board::setOutput(int fd) {
+    view.setOutput(fd);
+}
 
-        cout << "║";
-        cout << string(width - margin - 2, ' ') << "║" << endl;
-    }
+void Board::setThreadCount(int threads) {
+    enemies.setThreadCount(threads);
+}
+
+void Board::setPerfHud(bool enabled) {
+    if (enabled && !perf) perf.reset(new PerfStats());
+    if (!enabled) perf.reset();
+}
+
+// Null while the panel is off.
+const PerfStats* Board::getPerfStats() const {
+    return perf.get();
 }
@@ -6,47 +6,108 @@ using namespace std;
 #include "Wall.h"
 #include "GoldMine.h"
 #include "ElixirCollector.h"
-#include "Enemy.h"
+#include "EnemyPool.h"
+#include "FlowField.h"
+#include "OccupancyGrid.h"
+#include "PerfStats.h"
+#include "SaveFile.h"
+#include "StateStream.h"
+#include "TimerWheel.h"
+#include "Tracer.h"
+#include "WorldView.h"
+#include <memory>
+#include <random>
 #include <vector>
 #include <string>
 
+// Worlds the command line accepts and saves may describe. Building coordinates are 16-bit, so
+// the largest world must stay well inside that range.
+static const int MIN_WORLD_WIDTH = 20, MIN_WORLD_HEIGHT = 10;
+static const int MAX_WORLD_SIZE = 4096;
+
 class Board {
 private:
-    const int width = 147;
-    const int height = 33;
-    const int margin = 30;
+    const int width;
+    const int height;
 
     Player player;
     TownHall townhall;
     vector<Wall> walls;
     vector<GoldMine> goldMines;
     vector<ElixirCollector> elixirCollectors;
-    vector<Enemy> enemies;
-    vector<string> leftTexts;
-    int spawnCounter;
+    TimerWheel timers;
+    vector<TimerWheel::Timer> firedTimers;
+    EnemyPool enemies;
+    long long nextSpawn;
     const int spawnRate;
     bool gameOver;
+    long long tick;
+    unsigned seed;
+    mt19937 rng;
+    int fieldLeft, fieldTop, fieldRight, fieldBottom;
+    bool hasAnchor;
+    Position anchor;
+    vector<Position> wallCells;
+    OccupancyGrid occupancy;
+    FlowField flowField;
+    WorldView view;
+    unique_ptr<PerfStats> perf;
+    vector<Building*> visibleBuildings[ELIXIR_COLLECTOR + 1];
 
-    void drawBuilding(const Building& building) const;
-    bool areBuildingsColliding(const Building& b1, const Building& b2) const;
-    bool isPositionOccupied(const Position& pos, const Building* ignore = nullptr) const;
-    bool CanBuild(const Building* building, const Building* ignore = nullptr) const;
+    template <typename T> void drawBuilding(const T& building, GlyphId icon);
+    template <typename T> bool placeCentered(vector<T>& buildings);
+    bool placeWalls();
     void spawnEnemy();
     void updateEnemies();
-    void renderTopBorder() const;
-    void renderBottomBorder() const;
-    void renderMiddle() const;
+    void draw();
+    void renderPerf();
+
+    friend bool saveBoard(const Board& board, const string& path);
+    friend unique_ptr<Board> loadBoard(const string& path, int viewWidth, int viewHeight);
+    friend void captureState(const Board& board, StateSnapshot& snapshot);
 
 public:
     Board();
+    Board(int width, int height, unsigned seed = 1, int viewWidth = 147, int viewHeight = 33);
+    int getWidth() const;
+    int getHeight() const;
+    int getFieldLeft() const;
+    int getFieldTop() const;
+    int getFieldRight() const;
+    int getFieldBottom() const;
+    bool isGameOver() const;
+    long long getTick() const;
+    unsigned getSeed() const;
+    unsigned long long checksum() const;
+    string describeState() const;
     bool tryMovePlayer(char direction);
     bool placeWall();
+    bool setWallAnchor();
+    bool placeWallLine();
+    bool placeWallRectangle();
     bool placeGoldMine();
     bool placeElixirCollector();
     void collectResources();
-    void updateResources();
+    int attackNearby();
+    bool applyCommand(char command);
+    bool isPositionOccupied(const Position& pos, const Building* ignore = nullptr) const;
+    template <typename T> bool CanBuild(const T& building, const Building* ignore = nullptr) const;
+    bool addWall(int x, int y);
+    void spawnEnemyAt(int x, int y);
     void update();
     void render();
+    void invalidateScreen();
+    void setOutput(int fd);
+    void setThreadCount(int threads);
+    void setPerfHud(bool enabled);
+    const PerfStats* getPerfStats() const;
 };
 
+// Only typed buildings can be checked, so the footprint is always a compile-time constant.
+template <typename T>
+bool Board::CanBuild(const T& building, const Building* ignore) const {
+    Position pos = building.getPosition();
+    return occupancy.isAreaFree(pos.x, pos.y, T::getSizeX(), T::getSizeY(), ignore);
+}
+
 #endif
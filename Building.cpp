@@ -1,19 +1,43 @@
 #include "Building.h"
+#include <algorithm>
 using namespace std;
-Building::Building(int x, int y, int sizeX, int sizeY, int costGold, int costElixir, 
-         int health, int maxInstances, const string& icon, bool hasBorder)
-    : pos(x, y), sizeX(sizeX), sizeY(sizeY), costGold(costGold), 
-      costElixir(costElixir), health(health), maxInstances(maxInstances), 
-      icon(icon), hasBorder(hasBorder) {}
 
-const Position& Building::getPosition() const { return pos; }
-const string& Building::getIcon() const { return icon; }
-int Building::getCostGold() const { return costGold; }
-int Building::getCostElixir() const { return costElixir; }
+struct BuildingStats {
+    int sizeX, sizeY;
+    int costGold, costElixir;
+    int health;
+    int maxInstances;
+    GlyphId icon;
+    bool hasBorder;
+};
+
+template <BuildingType Type>
+static constexpr BuildingStats statsOf() {
+    typedef BuildingTraits<Type> T;
+    return { T::sizeX, T::sizeY, T::costGold, T::costElixir, T::health, T::maxInstances, T::icon, T::hasBorder };
+}
+
+// Indexed by BuildingType.
+static const BuildingStats stats[] = {
+    statsOf<TOWN_HALL>(), statsOf<WALL>(), statsOf<GOLD_MINE>(), statsOf<ELIXIR_COLLECTOR>()
+};
+
+Building::Building(BuildingType type, int x, int y)
+    : x(x), y(y), health(stats[type].health), type(type) {}
+
+BuildingType Building::getType() const { return type; }
+Position Building::getPosition() const { return Position(x, y); }
+GlyphId Building::getIcon() const { return stats[type].icon; }
+int Building::getCostGold() const { return stats[type].costGold; }
+int Building::getCostElixir() const { return stats[type].costElixir; }
 int Building::getHealth() const { return health; }
-int Building::getMaxInstances() const { return maxInstances; }
-int Building::getSizeX() const { return sizeX; }
-int Building::getSizeY() const { return sizeY; }
-bool Building::Border() const { return hasBorder; }
-void Building::setPosition(int x, int y) { pos = Position(x, y); }
-void Building::takeDamage(int damage) { health -= damage; }
+int Building::getMaxInstances() const { return stats[type].maxInstances; }
+int Building::getSizeX() const { return stats[type].sizeX; }
+int Building::getSizeY() const { return stats[type].sizeY; }
+bool Building::Border() const { return stats[type].hasBorder; }
+void Building::setPosition(int newX, int newY) {
+    x = newX;
+    y = newY;
+}
+// A tick's damage lands all at once and can exceed what 16 bits hold, so health stops at zero.
+void Building::takeDamage(int damage) { health = max(0, health - damage); }
@@ -1,24 +1,27 @@
 #ifndef BUILDING_H
 #define BUILDING_H
 
+#include "BuildingTraits.h"
+#include "Glyph.h"
 #include "Position.h"
+#include <cstdint>
 #include <string>
 using namespace std;
+
+// An instance holds only what changes during a game; its fixed stats are looked up by type, and
+// its registry handle is the one stamped on its cells in the occupancy grid. Coordinates fit in
+// 16 bits because worlds are at most 4096 cells across.
 class Building {
 protected:
-    Position pos;
-    int sizeX, sizeY;
-    int costGold, costElixir;
-    int health;
-    int maxInstances;
-    string icon;
-    bool hasBorder;
+    int16_t x, y;
+    int16_t health;
+    BuildingType type;
 public:
-    Building(int x, int y, int sizeX, int sizeY, int costGold, int costElixir, 
-             int health, int maxInstances, const string& icon, bool hasBorder = true);
+    Building(BuildingType type, int x, int y);
     
-    const Position& getPosition() const;
-    const string& getIcon() const;
+    BuildingType getType() const;
+    Position getPosition() const;
+    GlyphId getIcon() const;
     int getCostGold() const;
     int getCostElixir() const;
     int getHealth() const;
@@ -30,4 +33,21 @@ public:
     void takeDamage(int damage);
 };
 
+// A building whose type is known at compile time. Its stat getters hide Building's lookups with
+// the trait constants, so footprint and cost arithmetic on a Wall or GoldMine folds away.
+template <BuildingType Type>
+class TypedBuilding : public Building {
+public:
+    typedef BuildingTraits<Type> Traits;
+
+    TypedBuilding(int x, int y) : Building(Type, x, y) {}
+    static constexpr GlyphId getIcon() { return Traits::icon; }
+    static constexpr int getCostGold() { return Traits::costGold; }
+    static constexpr int getCostElixir() { return Traits::costElixir; }
+    static constexpr int getMaxInstances() { return Traits::maxInstances; }
+    static constexpr int getSizeX() { return Traits::sizeX; }
+    static constexpr int getSizeY() { return Traits::sizeY; }
+    static constexpr bool Border() { return Traits::hasBorder; }
+};
+
 #endif
@@ -0,0 +1,18 @@
+#ifndef BUILDINGHANDLE_H
+#define BUILDINGHANDLE_H
+
+// Names a building by registry slot and generation. The slot is reused once the building is
+// gone, but the generation moves on, so an old handle can be detected instead of dangling.
+// Generation 0 is never issued, which makes a zeroed handle mean "no building".
+struct BuildingHandle {
+    unsigned index;
+    unsigned generation;
+
+    bool isNone() const { return generation == 0; }
+    bool operator==(const BuildingHandle& other) const {
+        return index == other.index && generation == other.generation;
+    }
+    bool operator!=(const BuildingHandle& other) const { return !(*this == other); }
+};
+
+#endif
@@ -0,0 +1,45 @@
+#include "BuildingRegistry.h"
+using namespace std;
+
+bool BuildingRegistry::isCurrent(const BuildingHandle& handle) const {
+    return handle.index < generations.size() && generations[handle.index] == handle.generation;
+}
+
+BuildingHandle BuildingRegistry::add(Building* building) {
+    unsigned index;
+    if (!freeSlots.empty()) {
+        index = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        index = buildings.size();
+        buildings.push_back(nullptr);
+        generations.push_back(1);
+    }
+    buildings[index] = building;
+    BuildingHandle handle = { index, generations[index] };
+    return handle;
+}
+
+void BuildingRegistry::remove(const BuildingHandle& handle) {
+    if (!isCurrent(handle)) return;
+    buildings[handle.index] = nullptr;
+    if (++generations[handle.index] == 0) generations[handle.index] = 1;
+    freeSlots.push_back(handle.index);
+}
+
+void BuildingRegistry::relocate(const BuildingHandle& handle, Building* building) {
+    if (isCurrent(handle)) buildings[handle.index] = building;
+}
+
+Building* BuildingRegistry::get(const BuildingHandle& handle) const {
+    return isCurrent(handle) ? buildings[handle.index] : nullptr;
+}
+
+// Slots are walked by index; a free slot holds no building.
+size_t BuildingRegistry::slotCount() const {
+    return buildings.size();
+}
+
+Building* BuildingRegistry::at(size_t index) const {
+    return buildings[index];
+}
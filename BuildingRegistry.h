@@ -0,0 +1,27 @@
+#ifndef BUILDINGREGISTRY_H
+#define BUILDINGREGISTRY_H
+using namespace std;
+#include "Building.h"
+#include "BuildingHandle.h"
+#include <vector>
+
+// Maps handles to wherever the building currently lives. Buildings sit in vectors that grow and
+// compact, so the owner reports each move through relocate and handles stay valid throughout.
+class BuildingRegistry {
+private:
+    vector<Building*> buildings;
+    vector<unsigned> generations;
+    vector<unsigned> freeSlots;
+
+    bool isCurrent(const BuildingHandle& handle) const;
+
+public:
+    BuildingHandle add(Building* building);
+    void remove(const BuildingHandle& handle);
+    void relocate(const BuildingHandle& handle, Building* building);
+    Building* get(const BuildingHandle& handle) const;
+    size_t slotCount() const;
+    Building* at(size_t index) const;
+};
+
+#endif
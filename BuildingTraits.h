@@ -0,0 +1,58 @@
+#ifndef BUILDINGTRAITS_H
+#define BUILDINGTRAITS_H
+
+#include "Glyph.h"
+
+enum BuildingType : unsigned char { TOWN_HALL, WALL, GOLD_MINE, ELIXIR_COLLECTOR };
+
+// Stats fixed per building type. Code that knows the type reads them from BuildingTraits, where
+// they are compile-time constants; code holding a plain Building looks them up by type tag.
+template <BuildingType Type>
+struct BuildingTraits;
+
+template <>
+struct BuildingTraits<TOWN_HALL> {
+    static constexpr int sizeX = 9, sizeY = 5;
+    static constexpr int costGold = 0, costElixir = 0;
+    static constexpr int health = 500;
+    static constexpr int maxInstances = 1;
+    static constexpr GlyphId icon = GLYPH_TOWN_HALL;
+    static constexpr bool hasBorder = true;
+};
+
+template <>
+struct BuildingTraits<WALL> {
+    static constexpr int sizeX = 1, sizeY = 1;
+    static constexpr int costGold = 10, costElixir = 0;
+    static constexpr int health = 100;
+    static constexpr int maxInstances = 200;
+    static constexpr GlyphId icon = GLYPH_WALL;
+    static constexpr bool hasBorder = false;
+};
+
+// Generators also fix how much they hold, how fast they fill, and the icon they show when full.
+template <>
+struct BuildingTraits<GOLD_MINE> {
+    static constexpr int sizeX = 7, sizeY = 3;
+    static constexpr int costGold = 0, costElixir = 100;
+    static constexpr int health = 100;
+    static constexpr int maxInstances = 3;
+    static constexpr GlyphId icon = GLYPH_GOLD_MINE_EMPTY;
+    static constexpr bool hasBorder = true;
+    static constexpr GlyphId fullIcon = GLYPH_GOLD_MINE_FULL;
+    static constexpr int capacity = 100, rate = 5;
+};
+
+template <>
+struct BuildingTraits<ELIXIR_COLLECTOR> {
+    static constexpr int sizeX = 7, sizeY = 3;
+    static constexpr int costGold = 100, costElixir = 0;
+    static constexpr int health = 100;
+    static constexpr int maxInstances = 3;
+    static constexpr GlyphId icon = GLYPH_ELIXIR_EMPTY;
+    static constexpr bool hasBorder = true;
+    static constexpr GlyphId fullIcon = GLYPH_ELIXIR_FULL;
+    static constexpr int capacity = 100, rate = 5;
+};
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef CHUNKEDGRID_H
+#define CHUNKEDGRID_H
+using namespace std;
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// A grid stored as CHUNK_SIZE x CHUNK_SIZE chunks that are allocated the first time one of their
+// cells is written. Reads from a chunk that was never written return the fill value, so memory
+// follows the parts of the map that hold something rather than the map's area.
+template <typename T>
+class ChunkedGrid {
+public:
+    static const int CHUNK_SHIFT = 6;
+    static const int CHUNK_SIZE = 1 << CHUNK_SHIFT;
+
+private:
+    int width;
+    int height;
+    int chunksX;
+    int chunksY;
+    T fillValue;
+    vector<unique_ptr<T[]> > chunks;
+    size_t allocatedChunks;
+
+    static int cellIndex(int x, int y) {
+        return ((y & (CHUNK_SIZE - 1)) << CHUNK_SHIFT) | (x & (CHUNK_SIZE - 1));
+    }
+    int chunkIndex(int x, int y) const {
+        return (y >> CHUNK_SHIFT) * chunksX + (x >> CHUNK_SHIFT);
+    }
+
+public:
+    ChunkedGrid(int width, int height, const T& fillValue = T())
+        : width(width), height(height),
+          chunksX((width + CHUNK_SIZE - 1) / CHUNK_SIZE),
+          chunksY((height + CHUNK_SIZE - 1) / CHUNK_SIZE),
+          fillValue(fillValue), chunks(chunksX * chunksY), allocatedChunks(0) {}
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    size_t getAllocatedChunks() const { return allocatedChunks; }
+
+    bool contains(int x, int y) const {
+        return x >= 0 && y >= 0 && x < width && y < height;
+    }
+
+    T get(int x, int y) const {
+        if (!contains(x, y)) return fillValue;
+        const unique_ptr<T[]>& chunk = chunks[chunkIndex(x, y)];
+        return chunk ? chunk[cellIndex(x, y)] : fillValue;
+    }
+
+    // Calls visit(x, y, value) for every cell of the inclusive rectangle that lies in an allocated
+    // chunk. Chunks that were never written are skipped whole, so the cost follows the chunks the
+    // rectangle touches that hold something.
+    template <typename F>
+    void forEachAllocated(int left, int top, int right, int bottom, F visit) const {
+        left = max(left, 0);
+        top = max(top, 0);
+        right = min(right, width - 1);
+        bottom = min(bottom, height - 1);
+        for (int cy = top >> CHUNK_SHIFT; cy <= bottom >> CHUNK_SHIFT && top <= bottom; ++cy) {
+            for (int cx = left >> CHUNK_SHIFT; cx <= right >> CHUNK_SHIFT && left <= right; ++cx) {
+                const unique_ptr<T[]>& chunk = chunks[cy * chunksX + cx];
+                if (!chunk) continue;
+                int yMin = max(top, cy << CHUNK_SHIFT), yMax = min(bottom, ((cy + 1) << CHUNK_SHIFT) - 1);
+                int xMin = max(left, cx << CHUNK_SHIFT), xMax = min(right, ((cx + 1) << CHUNK_SHIFT) - 1);
+                for (int y = yMin; y <= yMax; ++y) {
+                    for (int x = xMin; x <= xMax; ++x) visit(x, y, chunk[cellIndex(x, y)]);
+                }
+            }
+        }
+    }
+
+    // The cell must lie inside the grid; its chunk is allocated on first use.
+    T& ref(int x, int y) {
+        unique_ptr<T[]>& chunk = chunks[chunkIndex(x, y)];
+        if (!chunk) {
+            chunk.reset(new T[CHUNK_SIZE * CHUNK_SIZE]);
+            for (int i = 0; i < CHUNK_SIZE * CHUNK_SIZE; ++i) chunk[i] = fillValue;
+            ++allocatedChunks;
+        }
+        return chunk[cellIndex(x, y)];
+    }
+};
+
+#endif
@@ -0,0 +1,153 @@
+#include "Client.h"
+#include "Building.h"
+#include "EnemyArchetype.h"
+#include "InputManager.h"
+#include "StateStream.h"
+#include "WorldView.h"
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+using namespace std;
+
+static int connectTo(const string& path) {
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) return -1;
+    memcpy(address.sun_path, path.c_str(), path.size());
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    if (connect(fd, (sockaddr*)&address, sizeof(address)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void sendCommand(int fd, char command) {
+    send(fd, &command, 1, MSG_NOSIGNAL);
+}
+
+static void render(WorldView& view, const StateSnapshot& state) {
+    Position player(state.playerX, state.playerY);
+    view.begin(player);
+    PanelStatus status = { state.gold, state.elixir,
+                           state.countBuildings(WALL), state.countBuildings(GOLD_MINE), state.countBuildings(ELIXIR_COLLECTOR),
+                           state.getTownHallHealth(), state.countEnemies(), player };
+    view.drawPanel(status);
+
+    for (const StateSnapshot::BuildingState& building : state.buildings) {
+        view.drawBuilding(Position(building.x, building.y), building.sizeX, building.sizeY, building.border, building.icon);
+    }
+    if (state.hasAnchor) view.put(state.anchorX, state.anchorY, '+');
+
+    for (const StateSnapshot::EnemyState& enemy : state.enemies) {
+        if (enemy.alive) view.put(enemy.x, enemy.y, getEnemyArchetype(enemy.kind).icon);
+    }
+
+    view.put(player.x, player.y, GLYPH_PLAYER);
+
+    if (state.gameOver) view.showMessage("GAME OVER - Town Hall Destroyed!");
+
+    view.present();
+}
+
+// A thin viewer: keys go to the server as they are typed and the screen shows the last state it
+// sent. Every message waiting on the socket is applied before drawing, so a viewer that falls
+// behind skips frames rather than replaying them. Headless, it plays a script one command per
+// state received and prints the state it ended with.
+int runClient(const ClientOptions& options) {
+    string script;
+    if (!options.scriptPath.empty()) {
+        ifstream in(options.scriptPath.c_str());
+        if (!in) {
+            cerr << "cannot open script " << options.scriptPath << endl;
+            return 1;
+        }
+        script.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+    }
+
+    int fd = connectTo(options.socketPath);
+    if (fd < 0) {
+        cerr << "cannot connect to " << options.socketPath << ": " << strerror(errno) << endl;
+        return 1;
+    }
+
+    unique_ptr<InputManager> input;
+    if (!options.headless) {
+        input.reset(new InputManager());
+        cout << "\033[?25l" << flush;
+    }
+
+    MessageReader reader;
+    StateSnapshot state;
+    unique_ptr<WorldView> view;
+    size_t scriptIndex = 0;
+    bool running = true, malformed = false;
+    while (running) {
+        char key;
+        while (input && input->poll(key)) {
+            if (key == 'Q') {
+                running = false;
+                break;
+            }
+            sendCommand(fd, key);
+        }
+        if (!running) break;
+
+        pollfd fds[2] = { { fd, POLLIN, 0 }, { STDIN_FILENO, POLLIN, 0 } };
+        if (poll(fds, input ? 2 : 1, -1) < 0 && errno != EINTR) break;
+        if (!(fds[0].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+
+        char buffer[65536];
+        ssize_t count = recv(fd, buffer, sizeof(buffer), 0);
+        if (count < 0 && errno == EINTR) continue;
+        if (count <= 0) break;
+        reader.append(buffer, count);
+
+        bool updated = false;
+        char type;
+        string body;
+        while (running && reader.next(type, body)) {
+            if (type == MESSAGE_HELLO) {
+                int width, height;
+                if (!decodeHello(body, width, height)) {
+                    malformed = true;
+                    running = false;
+                } else if (!options.headless) {
+                    view.reset(new WorldView(width, height, options.viewWidth, options.viewHeight));
+                }
+            } else if (type == MESSAGE_STATE) {
+                if (!applyState(state, body)) {
+                    malformed = true;
+                    running = false;
+                }
+                updated = true;
+                if (scriptIndex < script.size()) sendCommand(fd, toupper(script[scriptIndex++]));
+            }
+        }
+        if (reader.isCorrupt()) {
+            malformed = true;
+            running = false;
+        }
+        if (updated && view && !malformed) render(*view, state);
+    }
+    close(fd);
+
+    if (input) cout << "\033[" << options.viewHeight + 1 << ";1H\033[?25h" << flush;
+    if (malformed) {
+        cerr << "malformed message from server" << endl;
+        return 1;
+    }
+    if (options.headless) cout << state.describe() << endl;
+    return 0;
+}
@@ -0,0 +1,16 @@
+#ifndef CLIENT_H
+#define CLIENT_H
+using namespace std;
+#include <string>
+
+struct ClientOptions {
+    string socketPath;
+    bool headless;
+    string scriptPath;
+    int viewWidth;
+    int viewHeight;
+};
+
+int runClient(const ClientOptions& options);
+
+#endif
@@ -3,12 +3,9 @@
 
 #include "ResourceGenerator.h"
 
-class ElixirCollector : public ResourceGenerator {
+class ElixirCollector : public ResourceGenerator<ELIXIR_COLLECTOR> {
 public:
-    ElixirCollector(int x, int y);
-    ElixirCollector& operator=(const ElixirCollector& other);
-    void update() override;
-    int collect() override;
+    ElixirCollector(int x, int y, long long placedAt = 0);
 };
 
 #endif
@@ -0,0 +1,9 @@
+#include "EnemyArchetype.h"
+
+static const EnemyArchetype archetypes[ENEMY_KIND_COUNT] = {
+    { GLYPH_GRUNT, 100, 10, 3 },
+};
+
+const EnemyArchetype& getEnemyArchetype(int kind) {
+    return archetypes[kind];
+}
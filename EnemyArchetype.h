@@ -0,0 +1,17 @@
+#ifndef ENEMYARCHETYPE_H
+#define ENEMYARCHETYPE_H
+using namespace std;
+#include "Glyph.h"
+
+enum EnemyKind { GRUNT, ENEMY_KIND_COUNT };
+
+struct EnemyArchetype {
+    GlyphId icon;
+    int health;
+    int damage;
+    int speed;
+};
+
+const EnemyArchetype& getEnemyArchetype(int kind);
+
+#endif
@@ -0,0 +1,168 @@
+#include "EnemyPool.h"
+#include "Tracer.h"
+#include <algorithm>
+#include <thread>
+
+static const size_t PARALLEL_THRESHOLD = 4096;
+static const int CHUNKS_PER_THREAD = 4;
+
+EnemyPool::EnemyPool(TimerWheel& timers) : timers(timers), liveCount(0), lastUpdate(timers.getTick()) {
+    setThreadCount(thread::hardware_concurrency());
+}
+
+void EnemyPool::setThreadCount(int threads) {
+    workers.reset(new WorkerPool(max(threads, 1)));
+}
+
+// Dead slots are recycled before the arrays grow, so storage tracks the peak live count rather than the total ever spawned.
+// A new enemy first acts speed ticks after the last update, the same as if it had been counting down since then.
+size_t EnemyPool::spawn(int spawnX, int spawnY, int enemyKind) {
+    size_t slot;
+    if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        slot = x.size();
+        x.push_back(0);
+        y.push_back(0);
+        health.push_back(0);
+        wakeAt.push_back(0);
+        state.push_back(MOVING);
+        kind.push_back(0);
+        alive.push_back(0);
+        target.push_back(BuildingHandle());
+    }
+
+    const EnemyArchetype& archetype = getEnemyArchetype(enemyKind);
+    x[slot] = spawnX;
+    y[slot] = spawnY;
+    health[slot] = archetype.health;
+    wakeAt[slot] = max(lastUpdate + archetype.speed, timers.getTick() + 1);
+    state[slot] = MOVING;
+    kind[slot] = enemyKind;
+    alive[slot] = 1;
+    target[slot] = BuildingHandle();
+    ++liveCount;
+    timers.schedule(wakeAt[slot], TIMER_ENEMY, slot);
+    return slot;
+}
+
+void EnemyPool::despawn(size_t slot) {
+    if (!alive[slot]) return;
+    alive[slot] = 0;
+    freeSlots.push_back(slot);
+    --liveCount;
+}
+
+int EnemyPool::damageArea(int left, int top, int right, int bottom, int amount) {
+    int hit = 0;
+    for (size_t slot = 0; slot < x.size(); ++slot) {
+        if (!alive[slot] || x[slot] < left || x[slot] > right || y[slot] < top || y[slot] > bottom) continue;
+        health[slot] -= amount;
+        if (health[slot] <= 0) despawn(slot);
+        ++hit;
+    }
+    return hit;
+}
+
+size_t EnemyPool::size() const { return liveCount; }
+size_t EnemyPool::slotCount() const { return x.size(); }
+bool EnemyPool::isAlive(size_t slot) const { return alive[slot]; }
+int EnemyPool::getX(size_t slot) const { return x[slot]; }
+int EnemyPool::getY(size_t slot) const { return y[slot]; }
+int EnemyPool::getHealth(size_t slot) const { return health[slot]; }
+EnemyPool::State EnemyPool::getState(size_t slot) const { return (State)state[slot]; }
+const EnemyArchetype& EnemyPool::getArchetype(size_t slot) const { return getEnemyArchetype(kind[slot]); }
+
+// Each chunk only reads the board and writes its own enemies and buffers, so chunks can run on any thread.
+void EnemyPool::updateRange(size_t begin, size_t end, int chunk,
+                            const FlowField& flowField, const OccupancyGrid& occupancy) {
+    vector<DamageIntent>& damage = damageBuffers[chunk];
+    vector<size_t>& despawns = despawnBuffers[chunk];
+
+    for (size_t d = begin; d < end; ++d) {
+        size_t i = due[d];
+        const EnemyArchetype& archetype = getEnemyArchetype(kind[i]);
+
+        // An attacker stays on its target's footprint, so a live handle saves the grid lookup.
+        Building* building = state[i] == ATTACKING ? occupancy.resolve(target[i]) : nullptr;
+        if (!building) building = occupancy.at(x[i], y[i]);
+        if (building && building->getType() == TOWN_HALL) {
+            // Reaching the town hall spends the enemy on a single strike.
+            DamageIntent intent = { building, archetype.damage, i };
+            damage.push_back(intent);
+            despawns.push_back(i);
+            continue;
+        }
+
+        if (building && building->getHealth() > 0) {
+            DamageIntent intent = { building, archetype.damage, i };
+            damage.push_back(intent);
+            state[i] = ATTACKING;
+            target[i] = occupancy.handleAt(x[i], y[i]);
+            continue;
+        }
+
+        state[i] = MOVING;
+        Position step = flowField.nextStep(Position(x[i], y[i]));
+        x[i] = step.x;
+        y[i] = step.y;
+    }
+}
+
+// Only enemies whose wake-up fired this tick run. Stale timers left by dead or recycled slots no
+// longer match wakeAt and are dropped. Due enemies are taken in slot order, each decides against
+// the board as it was at the start of the tick, and damage is applied afterwards in that order,
+// so the result does not depend on how many threads took part.
+bool EnemyPool::update(const vector<TimerWheel::Timer>& fired, const FlowField& flowField, const OccupancyGrid& occupancy) {
+    long long tick = timers.getTick();
+    due.clear();
+    for (const TimerWheel::Timer& timer : fired) {
+        if (timer.channel == TIMER_ENEMY && alive[timer.id] && wakeAt[timer.id] == timer.due) due.push_back(timer.id);
+    }
+    // Timers fire in the order they were scheduled, which is already slot order unless spawns reused lower slots.
+    if (!is_sorted(due.begin(), due.end())) sort(due.begin(), due.end());
+    due.erase(unique(due.begin(), due.end()), due.end());
+
+    size_t count = due.size();
+    int chunks = 1;
+    if (count >= PARALLEL_THRESHOLD) chunks = workers->size() * CHUNKS_PER_THREAD;
+    size_t chunkSize = (count + chunks - 1) / chunks;
+
+    if ((int)damageBuffers.size() < chunks) {
+        damageBuffers.resize(chunks);
+        despawnBuffers.resize(chunks);
+    }
+    for (int c = 0; c < chunks; ++c) {
+        damageBuffers[c].clear();
+        despawnBuffers[c].clear();
+    }
+
+    workers->run(chunks, [&](int chunk) {
+        TraceSpan span("enemy batch");
+        size_t begin = min(count, chunk * chunkSize);
+        size_t end = min(count, begin + chunkSize);
+        updateRange(begin, end, chunk, flowField, occupancy);
+    });
+
+    bool townHallDestroyed = false;
+    for (int c = 0; c < chunks; ++c) {
+        for (const DamageIntent& intent : damageBuffers[c]) intent.building->takeDamage(intent.damage);
+    }
+    for (int c = 0; c < chunks; ++c) {
+        for (const DamageIntent& intent : damageBuffers[c]) {
+            if (intent.building->getHealth() > 0) continue;
+            if (intent.building->getType() == TOWN_HALL) townHallDestroyed = true;
+            state[intent.enemy] = MOVING;
+        }
+        for (size_t slot : despawnBuffers[c]) despawn(slot);
+    }
+
+    for (size_t slot : due) {
+        if (!alive[slot]) continue;
+        wakeAt[slot] = tick + getEnemyArchetype(kind[slot]).speed;
+        timers.schedule(wakeAt[slot], TIMER_ENEMY, slot);
+    }
+    lastUpdate = tick;
+    return townHallDestroyed;
+}
@@ -0,0 +1,65 @@
+#ifndef ENEMYPOOL_H
+#define ENEMYPOOL_H
+using namespace std;
+#include "EnemyArchetype.h"
+#include "FlowField.h"
+#include "OccupancyGrid.h"
+#include "SaveFile.h"
+#include "StateStream.h"
+#include "TimerWheel.h"
+#include "WorkerPool.h"
+#include <memory>
+#include <vector>
+
+class EnemyPool {
+private:
+    struct DamageIntent {
+        Building* building;
+        int damage;
+        size_t enemy;
+    };
+
+    TimerWheel& timers;
+    vector<int> x, y;
+    vector<int> health;
+    vector<long long> wakeAt;
+    vector<unsigned char> state;
+    vector<unsigned char> kind;
+    vector<unsigned char> alive;
+    vector<BuildingHandle> target;
+    vector<size_t> freeSlots;
+    size_t liveCount;
+    long long lastUpdate;
+    vector<size_t> due;
+
+    unique_ptr<WorkerPool> workers;
+    vector<vector<DamageIntent> > damageBuffers;
+    vector<vector<size_t> > despawnBuffers;
+
+    void updateRange(size_t begin, size_t end, int chunk,
+                     const FlowField& flowField, const OccupancyGrid& occupancy);
+
+    friend bool saveBoard(const Board& board, const string& path);
+    friend unique_ptr<Board> loadBoard(const string& path, int viewWidth, int viewHeight);
+    friend void captureState(const Board& board, StateSnapshot& snapshot);
+
+public:
+    enum State { MOVING, ATTACKING };
+
+    EnemyPool(TimerWheel& timers);
+    void setThreadCount(int threads);
+    size_t spawn(int x, int y, int kind = GRUNT);
+    void despawn(size_t slot);
+    int damageArea(int left, int top, int right, int bottom, int amount);
+    size_t size() const;
+    size_t slotCount() const;
+    bool isAlive(size_t slot) const;
+    int getX(size_t slot) const;
+    int getY(size_t slot) const;
+    int getHealth(size_t slot) const;
+    State getState(size_t slot) const;
+    const EnemyArchetype& getArchetype(size_t slot) const;
+    bool update(const vector<TimerWheel::Timer>& fired, const FlowField& flowField, const OccupancyGrid& occupancy);
+};
+
+#endif
@@ -1,11 +1,11 @@
 #include "Entity.h"
 using namespace std;
-Entity::Entity(int x, int y, const string& icon) : pos(x, y), icon(icon) {}
+Entity::Entity(int x, int y, GlyphId icon) : pos(x, y), icon(icon) {}
 
 const Position& Entity::getPosition() const {
     return pos;
 }
-const string& Entity::getIcon() const { return icon; }
+GlyphId Entity::getIcon() const { return icon; }
 void Entity::setPosition(int x, int y) {
     pos = Position(x, y);
 }
@@ -2,16 +2,16 @@
 #define ENTITY_H
 using namespace std;
 #include "Position.h"
-#include <string>
+#include "Glyph.h"
 
 class Entity {
 protected:
     Position pos;
-    string icon;
+    GlyphId icon;
 public:
-    Entity(int x, int y, const string& icon);
+    Entity(int x, int y, GlyphId icon);
     const Position& getPosition() const;
-    const string& getIcon() const;
+    GlyphId getIcon() const;
     void setPosition(int x, int y);
 };
 
@@ -0,0 +1,155 @@
+#include "FlowField.h"
+#include <algorithm>
+#include <climits>
+#include <functional>
+using namespace std;
+
+static const int directionX[8] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+static const int directionY[8] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+
+const int FlowField::UNREACHABLE = INT_MAX;
+
+FlowField::FlowField(int left, int top, int right, int bottom, int attackDamage)
+    : left(left), top(top), width(right - left + 1), height(bottom - top + 1),
+      attackDamage(attackDamage),
+      distance(width * height, UNREACHABLE), next(width * height, -1),
+      cost(width * height, 1) {}
+
+bool FlowField::contains(int x, int y) const {
+    return x >= left && y >= top && x < left + width && y < top + height;
+}
+
+int FlowField::indexOf(int x, int y) const {
+    return (y - top) * width + (x - left);
+}
+
+// Standing on a building means chewing through it first, one hit per move.
+int FlowField::computeCost(const OccupancyGrid& occupancy, int x, int y) const {
+    const Building* building = occupancy.at(x, y);
+    if (!building || building->getType() == TOWN_HALL || building->getHealth() <= 0) return 1;
+    return 1 + (building->getHealth() + attackDamage - 1) / attackDamage;
+}
+
+void FlowField::push(int index) {
+    open.push_back(Entry(distance[index], index));
+    push_heap(open.begin(), open.end(), greater<Entry>());
+}
+
+void FlowField::propagate() {
+    while (!open.empty()) {
+        pop_heap(open.begin(), open.end(), greater<Entry>());
+        Entry entry = open.back();
+        open.pop_back();
+        int index = entry.second;
+        if (entry.first != distance[index]) continue;
+
+        int x = left + index % width;
+        int y = top + index / width;
+        int through = distance[index] + cost[index];
+        for (int d = 0; d < 8; ++d) {
+            int nx = x + directionX[d];
+            int ny = y + directionY[d];
+            if (!contains(nx, ny)) continue;
+            int neighbor = indexOf(nx, ny);
+            if (through < distance[neighbor]) {
+                distance[neighbor] = through;
+                next[neighbor] = index;
+                push(neighbor);
+            }
+        }
+    }
+}
+
+void FlowField::rebuild(const OccupancyGrid& occupancy) {
+    fill(distance.begin(), distance.end(), UNREACHABLE);
+    fill(next.begin(), next.end(), -1);
+    open.clear();
+
+    for (int y = top; y < top + height; ++y) {
+        for (int x = left; x < left + width; ++x) {
+            int index = indexOf(x, y);
+            cost[index] = computeCost(occupancy, x, y);
+            const Building* building = occupancy.at(x, y);
+            if (building && building->getType() == TOWN_HALL) {
+                distance[index] = 0;
+                push(index);
+            }
+        }
+    }
+    propagate();
+}
+
+// Only cells whose path home runs through a changed cell are recomputed.
+void FlowField::repair(const OccupancyGrid& occupancy, int x, int y, int sizeX, int sizeY) {
+    changed.clear();
+    pending.clear();
+    invalidated.clear();
+    open.clear();
+
+    int xMin = max(x, left), xMax = min(x + sizeX, left + width);
+    int yMin = max(y, top), yMax = min(y + sizeY, top + height);
+    for (int cy = yMin; cy < yMax; ++cy) {
+        for (int cx = xMin; cx < xMax; ++cx) {
+            int index = indexOf(cx, cy);
+            int newCost = computeCost(occupancy, cx, cy);
+            if (newCost == cost[index]) continue;
+            bool increased = newCost > cost[index];
+            cost[index] = newCost;
+            changed.push_back(index);
+            // A cheaper cell only offers better paths; a dearer one breaks every path routed through it.
+            if (increased) pending.push_back(index);
+        }
+    }
+
+    for (size_t i = 0; i < pending.size(); ++i) {
+        int index = pending[i];
+        int cx = left + index % width;
+        int cy = top + index / width;
+        for (int d = 0; d < 8; ++d) {
+            int nx = cx + directionX[d];
+            int ny = cy + directionY[d];
+            if (!contains(nx, ny)) continue;
+            int child = indexOf(nx, ny);
+            if (next[child] != index || distance[child] == UNREACHABLE) continue;
+            distance[child] = UNREACHABLE;
+            next[child] = -1;
+            invalidated.push_back(child);
+            pending.push_back(child);
+        }
+    }
+
+    for (int index : invalidated) {
+        int cx = left + index % width;
+        int cy = top + index / width;
+        for (int d = 0; d < 8; ++d) {
+            int nx = cx + directionX[d];
+            int ny = cy + directionY[d];
+            if (!contains(nx, ny)) continue;
+            int neighbor = indexOf(nx, ny);
+            if (distance[neighbor] == UNREACHABLE) continue;
+            int through = distance[neighbor] + cost[neighbor];
+            if (through < distance[index]) {
+                distance[index] = through;
+                next[index] = neighbor;
+            }
+        }
+        if (distance[index] != UNREACHABLE) push(index);
+    }
+
+    for (int index : changed) {
+        if (distance[index] != UNREACHABLE) push(index);
+    }
+    propagate();
+}
+
+Position FlowField::nextStep(const Position& pos) const {
+    if (!contains(pos.x, pos.y)) return pos;
+    int step = next[indexOf(pos.x, pos.y)];
+    if (step < 0) return pos;
+    return Position(left + step % width, top + step / width);
+}
+
+int FlowField::getDistance(const Position& pos) const {
+    if (!contains(pos.x, pos.y)) return UNREACHABLE;
+    return distance[indexOf(pos.x, pos.y)];
+}
@@ -0,0 +1,44 @@
+#ifndef FLOWFIELD_H
+#define FLOWFIELD_H
+using namespace std;
+#include "OccupancyGrid.h"
+#include "Position.h"
+#include "SaveFile.h"
+#include <utility>
+#include <vector>
+
+class FlowField {
+private:
+    typedef pair<int, int> Entry;
+
+    int left, top;
+    int width, height;
+    int attackDamage;
+    vector<int> distance;
+    vector<int> next;
+    vector<int> cost;
+    vector<Entry> open;
+    vector<int> pending;
+    vector<int> changed;
+    vector<int> invalidated;
+
+    bool contains(int x, int y) const;
+    int indexOf(int x, int y) const;
+    int computeCost(const OccupancyGrid& occupancy, int x, int y) const;
+    void push(int index);
+    void propagate();
+
+    friend bool saveBoard(const Board& board, const string& path);
+    friend unique_ptr<Board> loadBoard(const string& path, int viewWidth, int viewHeight);
+
+public:
+    static const int UNREACHABLE;
+
+    FlowField(int left, int top, int right, int bottom, int attackDamage);
+    void rebuild(const OccupancyGrid& occupancy);
+    void repair(const OccupancyGrid& occupancy, int x, int y, int sizeX, int sizeY);
+    Position nextStep(const Position& pos) const;
+    int getDistance(const Position& pos) const;
+};
+
+#endif
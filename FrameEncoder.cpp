@@ -0,0 +1,155 @@
+#include "FrameEncoder.h"
+#include <cerrno>
+#include <cstdlib>
+#include <unistd.h>
+using namespace std;
+
+enum Motion { NONE, ABSOLUTE, RELATIVE, CARRIAGE_RETURN };
+
+static int digits(int value) {
+    int count = 1;
+    while (value >= 10) {
+        value /= 10;
+        ++count;
+    }
+    return count;
+}
+
+// CSI n A/B/C/D, where a count of 1 may be omitted.
+static int relativeCost(int distance) {
+    if (distance == 0) return 0;
+    return distance == 1 ? 3 : 3 + digits(distance);
+}
+
+static int absoluteCost(int x, int y) {
+    if (x == 1 && y == 1) return 3;
+    if (x == 1) return 3 + digits(y);
+    return 4 + digits(y) + digits(x);
+}
+
+static Motion chooseMotion(int fromX, int fromY, int x, int y, int& cost) {
+    if (fromX == x && fromY == y) {
+        cost = 0;
+        return NONE;
+    }
+
+    Motion best = ABSOLUTE;
+    cost = absoluteCost(x, y);
+    if (fromX <= 0 || fromY <= 0) return best;
+
+    int relative = relativeCost(abs(y - fromY)) + relativeCost(abs(x - fromX));
+    if (relative < cost) {
+        best = RELATIVE;
+        cost = relative;
+    }
+
+    int carriageReturn = 1 + relativeCost(abs(y - fromY)) + relativeCost(x - 1);
+    if (carriageReturn < cost) {
+        best = CARRIAGE_RETURN;
+        cost = carriageReturn;
+    }
+    return best;
+}
+
+FrameEncoder::FrameEncoder(int columns) : columns(columns), cursorX(0), cursorY(0), writes(0) {}
+
+void FrameEncoder::appendNumber(int value) {
+    char text[12];
+    int length = 0;
+    do {
+        text[length++] = '0' + value % 10;
+        value /= 10;
+    } while (value > 0);
+    while (length > 0) buffer += text[--length];
+}
+
+void FrameEncoder::appendRelative(int distance, char forward, char backward) {
+    if (distance == 0) return;
+    buffer += "\033[";
+    if (abs(distance) != 1) appendNumber(abs(distance));
+    buffer += distance > 0 ? forward : backward;
+}
+
+void FrameEncoder::appendMotion(int x, int y) {
+    int cost;
+    Motion motion = chooseMotion(cursorX, cursorY, x, y, cost);
+    if (motion == NONE) return;
+
+    if (motion == ABSOLUTE) {
+        buffer += "\033[";
+        if (x != 1 || y != 1) appendNumber(y);
+        if (x != 1) {
+            buffer += ';';
+            appendNumber(x);
+        }
+        buffer += 'H';
+        return;
+    }
+
+    int fromX = cursorX;
+    if (motion == CARRIAGE_RETURN) {
+        buffer += '\r';
+        fromX = 1;
+    }
+
+    appendRelative(y - cursorY, 'B', 'A');
+    appendRelative(x - fromX, 'C', 'D');
+}
+
+void FrameEncoder::beginFrame() {
+    buffer.clear();
+    // The cursor may have been moved by anything printed between frames.
+    cursorX = cursorY = 0;
+    buffer += "\033[?2026h";
+}
+
+void FrameEncoder::clearScreen() {
+    buffer += "\033[H\033[2J";
+    cursorX = cursorY = 1;
+}
+
+int FrameEncoder::moveCost(int x, int y) const {
+    int cost;
+    chooseMotion(cursorX, cursorY, x, y, cost);
+    return cost;
+}
+
+void FrameEncoder::moveTo(int x, int y) {
+    appendMotion(x, y);
+    cursorX = x;
+    cursorY = y;
+}
+
+void FrameEncoder::write(const char* bytes, int length, int width) {
+    buffer.append(bytes, length);
+    cursorX += width;
+    // Past the last column the terminal is in its pending-wrap state, where relative motion is unreliable.
+    if (cursorX > columns) cursorX = cursorY = 0;
+}
+
+void FrameEncoder::endFrame() {
+    buffer += "\033[?2026l";
+}
+
+bool FrameEncoder::flush(int fd) {
+    const char* data = buffer.data();
+    size_t remaining = buffer.size();
+    writes = 0;
+    while (remaining > 0) {
+        ssize_t written = ::write(fd, data, remaining);
+        ++writes;
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += written;
+        remaining -= written;
+    }
+    return true;
+}
+
+int FrameEncoder::getCursorX() const { return cursorX; }
+int FrameEncoder::getCursorY() const { return cursorY; }
+size_t FrameEncoder::size() const { return buffer.size(); }
+// How many write calls the last flush took, counting interrupted ones.
+int FrameEncoder::getWrites() const { return writes; }
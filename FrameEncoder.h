@@ -0,0 +1,32 @@
+#ifndef FRAMEENCODER_H
+#define FRAMEENCODER_H
+using namespace std;
+#include <string>
+
+class FrameEncoder {
+private:
+    string buffer;
+    int columns;
+    int cursorX, cursorY;
+    int writes;
+
+    void appendNumber(int value);
+    void appendRelative(int distance, char forward, char backward);
+    void appendMotion(int x, int y);
+
+public:
+    FrameEncoder(int columns);
+    void beginFrame();
+    void clearScreen();
+    int moveCost(int x, int y) const;
+    void moveTo(int x, int y);
+    void write(const char* bytes, int length, int width);
+    void endFrame();
+    bool flush(int fd);
+    int getCursorX() const;
+    int getCursorY() const;
+    size_t size() const;
+    int getWrites() const;
+};
+
+#endif
@@ -0,0 +1,47 @@
+#include "GameClock.h"
+#include <sys/prctl.h>
+#include <time.h>
+
+// Falling further behind than this drops the missed ticks instead of replaying them in a burst.
+static const int MAX_CATCH_UP_TICKS = 5;
+
+long long GameClock::now() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+GameClock::GameClock(int ticksPerSecond)
+    : tickNanos(1000000000LL / ticksPerSecond), deadline(now() + tickNanos),
+      ticks(0), totalLateness(0), maxLateness(0) {
+    // The default 50 us timer slack would otherwise dominate the wake-up jitter.
+    prctl(PR_SET_TIMERSLACK, 1UL, 0, 0, 0);
+}
+
+bool GameClock::due() {
+    long long current = now();
+    if (current < deadline) return false;
+
+    long long lateness = current - deadline;
+    ++ticks;
+    totalLateness += lateness;
+    if (lateness > maxLateness) maxLateness = lateness;
+
+    deadline += tickNanos;
+    if (lateness > MAX_CATCH_UP_TICKS * tickNanos) deadline = current + tickNanos;
+    return true;
+}
+
+long long GameClock::nanosUntilDeadline() const {
+    return deadline - now();
+}
+
+long long GameClock::getTicks() const { return ticks; }
+
+double GameClock::getMeanJitterMicros() const {
+    return ticks == 0 ? 0.0 : totalLateness / 1000.0 / ticks;
+}
+
+double GameClock::getMaxJitterMicros() const {
+    return maxLateness / 1000.0;
+}
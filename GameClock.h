@@ -0,0 +1,23 @@
+#ifndef GAMECLOCK_H
+#define GAMECLOCK_H
+
+class GameClock {
+private:
+    long long tickNanos;
+    long long deadline;
+    long long ticks;
+    long long totalLateness;
+    long long maxLateness;
+
+public:
+    static long long now();
+
+    GameClock(int ticksPerSecond);
+    bool due();
+    long long nanosUntilDeadline() const;
+    long long getTicks() const;
+    double getMeanJitterMicros() const;
+    double getMaxJitterMicros() const;
+};
+
+#endif
@@ -0,0 +1,34 @@
+#include "Glyph.h"
+#include <cstring>
+
+static const char* const namedGlyphs[GLYPH_COUNT - GLYPH_BOX_TOP_LEFT] = {
+    "┌", "┐", "└", "┘", "─", "│",
+    "╔", "╗", "╚", "╝", "═", "║", "╦", "╩",
+    "👷", "🏰", "🧱", "🪨", "🪙", "💧", "🧪", "👹",
+};
+
+struct GlyphTable {
+    GlyphInfo glyphs[256];
+
+    GlyphTable() : glyphs() {
+        for (int id = 1; id < 128; ++id) {
+            glyphs[id].bytes[0] = (char)id;
+            glyphs[id].length = 1;
+            glyphs[id].width = 1;
+        }
+        for (int id = GLYPH_BOX_TOP_LEFT; id < GLYPH_COUNT; ++id) {
+            const char* bytes = namedGlyphs[id - GLYPH_BOX_TOP_LEFT];
+            GlyphInfo& glyph = glyphs[id];
+            glyph.length = strlen(bytes);
+            memcpy(glyph.bytes, bytes, glyph.length);
+            // Emoji are the only 4-byte sequences the game draws and all of them are double width.
+            glyph.width = glyph.length == 4 ? 2 : 1;
+        }
+    }
+};
+
+static const GlyphTable table;
+
+const GlyphInfo& getGlyph(GlyphId id) {
+    return table.glyphs[id];
+}
@@ -0,0 +1,45 @@
+#ifndef GLYPH_H
+#define GLYPH_H
+using namespace std;
+
+// Glyphs are interned: ids below 128 are the ASCII characters themselves, the rest name the
+// box-drawing characters and emoji the game draws.
+typedef unsigned char GlyphId;
+
+enum : GlyphId {
+    GLYPH_CONTINUATION = 0,
+    GLYPH_SPACE = ' ',
+    GLYPH_BOX_TOP_LEFT = 128,
+    GLYPH_BOX_TOP_RIGHT,
+    GLYPH_BOX_BOTTOM_LEFT,
+    GLYPH_BOX_BOTTOM_RIGHT,
+    GLYPH_BOX_HORIZONTAL,
+    GLYPH_BOX_VERTICAL,
+    GLYPH_FRAME_TOP_LEFT,
+    GLYPH_FRAME_TOP_RIGHT,
+    GLYPH_FRAME_BOTTOM_LEFT,
+    GLYPH_FRAME_BOTTOM_RIGHT,
+    GLYPH_FRAME_HORIZONTAL,
+    GLYPH_FRAME_VERTICAL,
+    GLYPH_FRAME_TOP_TEE,
+    GLYPH_FRAME_BOTTOM_TEE,
+    GLYPH_PLAYER,
+    GLYPH_TOWN_HALL,
+    GLYPH_WALL,
+    GLYPH_GOLD_MINE_EMPTY,
+    GLYPH_GOLD_MINE_FULL,
+    GLYPH_ELIXIR_EMPTY,
+    GLYPH_ELIXIR_FULL,
+    GLYPH_GRUNT,
+    GLYPH_COUNT
+};
+
+struct GlyphInfo {
+    char bytes[4];
+    unsigned char length;
+    unsigned char width;
+};
+
+const GlyphInfo& getGlyph(GlyphId id);
+
+#endif
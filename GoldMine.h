@@ -3,12 +3,9 @@
 
 #include "ResourceGenerator.h"
 
-class GoldMine : public ResourceGenerator {
+class GoldMine : public ResourceGenerator<GOLD_MINE> {
 public:
-    GoldMine(int x, int y);
-    GoldMine& operator=(const GoldMine& other);
-    void update() override;
-    int collect() override;
+    GoldMine(int x, int y, long long placedAt = 0);
 };
 
 #endif
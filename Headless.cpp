@@ -0,0 +1,98 @@
+#include "Headless.h"
+#include "Board.h"
+#include "GameClock.h"
+#include "Recording.h"
+#include "SaveFile.h"
+#include "Tracer.h"
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <random>
+using namespace std;
+
+// Without a script, one generated command per tick drawn from the game's keys, idle ('.') included.
+static const char generatedCommands[] = "UDLRWMECBJK.";
+
+int runHeadless(const HeadlessOptions& options) {
+    string script;
+    if (!options.scriptPath.empty()) {
+        ifstream in(options.scriptPath.c_str());
+        if (!in) {
+            cerr << "cannot open script " << options.scriptPath << endl;
+            return 1;
+        }
+        script.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+    }
+
+    unique_ptr<Board> loaded;
+    if (options.loadPath.empty()) {
+        loaded.reset(new Board(options.width, options.height, options.seed));
+    } else {
+        long long start = GameClock::now();
+        loaded = loadBoard(options.loadPath);
+        if (!loaded) {
+            cerr << "cannot load save " << options.loadPath << endl;
+            return 1;
+        }
+        cout << "loaded tick=" << loaded->getTick() << " seconds=" << (GameClock::now() - start) / 1e9 << endl;
+    }
+    Board& board = *loaded;
+    if (options.threads > 0) board.setThreadCount(options.threads);
+    mt19937 gen(options.seed);
+    uniform_int_distribution<> pick(0, sizeof(generatedCommands) - 2);
+
+    long long start = GameClock::now();
+    long long tick = 0;
+    while (tick < options.ticks && !board.isGameOver()) {
+        char command;
+        if (options.scriptPath.empty()) {
+            command = generatedCommands[pick(gen)];
+        } else {
+            command = tick < (long long)script.size() ? toupper(script[tick]) : '.';
+        }
+        board.applyCommand(command);
+        board.update();
+        Tracer::flushIfRequested();
+        ++tick;
+    }
+    double seconds = (GameClock::now() - start) / 1e9;
+
+    cout << "ticks=" << tick << " seconds=" << seconds
+         << " ticksPerSecond=" << (seconds > 0 ? tick / seconds : 0) << endl;
+    cout << board.describeState() << endl;
+    if (!options.savePath.empty() && !saveBoard(board, options.savePath)) {
+        cerr << "cannot write save " << options.savePath << endl;
+        return 1;
+    }
+    return 0;
+}
+
+int runReplay(const string& path) {
+    Recording recording;
+    if (!loadRecording(path, recording)) {
+        cerr << "cannot read recording " << path << endl;
+        return 1;
+    }
+
+    Board board(recording.width, recording.height, recording.seed);
+    size_t next = 0;
+    long long start = GameClock::now();
+    while (true) {
+        while (next < recording.commands.size() && recording.commands[next].tick == board.getTick()) {
+            board.applyCommand(recording.commands[next++].command);
+        }
+        if (board.getTick() >= recording.endTick || board.isGameOver()) break;
+        board.update();
+        Tracer::flushIfRequested();
+    }
+    double seconds = (GameClock::now() - start) / 1e9;
+
+    bool matches = board.getTick() == recording.endTick && board.checksum() == recording.checksum;
+    cout << "ticks=" << board.getTick() << " seconds=" << seconds
+         << " ticksPerSecond=" << (seconds > 0 ? board.getTick() / seconds : 0) << endl;
+    cout << board.describeState() << endl;
+    cout << "checksum=" << hex << board.checksum() << dec << (matches ? " (matches recording)" : " (DIVERGED from recording)") << endl;
+    return matches ? 0 : 1;
+}
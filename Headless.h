@@ -0,0 +1,20 @@
+#ifndef HEADLESS_H
+#define HEADLESS_H
+using namespace std;
+#include <string>
+
+struct HeadlessOptions {
+    long long ticks;
+    unsigned seed;
+    string scriptPath;
+    int threads;
+    int width;
+    int height;
+    string savePath;
+    string loadPath;
+};
+
+int runHeadless(const HeadlessOptions& options);
+int runReplay(const string& path);
+
+#endif
@@ -1,13 +1,21 @@
 #include "InputManager.h"
-#include <cstdio>  
+#include "GameClock.h"
+#include <algorithm>
 #include <cctype>
+#include <cerrno>
+#include <poll.h>
 #include <unistd.h>
 #include <termios.h>
-InputManager::InputManager() {
+
+// How long the rest of an escape sequence may trail its ESC. Slow links split sequences across
+// reads, and the tail read alone would turn an arrow key into 'A', 'B' or 'C'.
+static const long long ESCAPE_TIMEOUT_NANOS = 100000000LL;
+
+InputManager::InputManager() : escapeStarted(0) {
     tcgetattr(STDIN_FILENO, &originalTerminalSettings);
     termios newSettings = originalTerminalSettings;
     newSettings.c_lflag &= ~(ICANON | ECHO);
-    newSettings.c_cc[VMIN] = 1;
+    newSettings.c_cc[VMIN] = 0;
     newSettings.c_cc[VTIME] = 0;
     tcsetattr(STDIN_FILENO, TCSANOW, &newSettings);
 }
@@ -16,17 +24,61 @@ InputManager::~InputManager() {
     tcsetattr(STDIN_FILENO, TCSANOW, &originalTerminalSettings);
 }
 
-char InputManager::getInput() const {
-    char ch = getchar();
+void InputManager::readAvailable() {
+    char buffer[64];
+    ssize_t count;
+    while ((count = read(STDIN_FILENO, buffer, sizeof(buffer))) > 0) {
+        pending.append(buffer, count);
+    }
+}
+
+bool InputManager::holdsPartialEscape() const {
+    return !pending.empty() && pending[0] == 27 && pending.size() < 3;
+}
+
+bool InputManager::poll(char& key) {
+    // An escape prefix whose tail has not come within the timeout was a lone escape.
+    if (holdsPartialEscape() && GameClock::now() - escapeStarted >= ESCAPE_TIMEOUT_NANOS) {
+        pending.clear();
+        escapeStarted = 0;
+    }
+    if (pending.empty() || holdsPartialEscape()) readAvailable();
+    if (pending.empty()) return false;
+
+    char ch = pending[0];
     if (ch == 27) {
-        getchar();
-        ch = getchar();
+        if (pending.size() < 3) {
+            // Held until the rest of the sequence arrives or the timeout drops it.
+            if (escapeStarted == 0) escapeStarted = GameClock::now();
+            return false;
+        }
+        escapeStarted = 0;
+        ch = pending[2];
+        pending.erase(0, 3);
         switch(ch) {
-            case 'A': return 'U';
-            case 'B': return 'D';
-            case 'C': return 'R';
-            case 'D': return 'L';
+            case 'A': key = 'U'; return true;
+            case 'B': key = 'D'; return true;
+            case 'C': key = 'R'; return true;
+            case 'D': key = 'L'; return true;
         }
+        key = toupper(ch);
+        return true;
     }
-    return toupper(ch);
+    pending.erase(0, 1);
+    key = toupper(ch);
+    return true;
+}
+
+bool InputManager::waitForInput(long long timeoutNanos) const {
+    // A held escape prefix is not a key yet, so only its timeout cuts the wait short.
+    if (!pending.empty() && !holdsPartialEscape()) return true;
+    if (holdsPartialEscape()) timeoutNanos = std::min(timeoutNanos, escapeStarted + ESCAPE_TIMEOUT_NANOS - GameClock::now());
+    if (timeoutNanos < 0) timeoutNanos = 0;
+
+    pollfd input = { STDIN_FILENO, POLLIN, 0 };
+    timespec timeout;
+    timeout.tv_sec = timeoutNanos / 1000000000LL;
+    timeout.tv_nsec = timeoutNanos % 1000000000LL;
+    int ready = ppoll(&input, 1, &timeout, nullptr);
+    return ready > 0 || (ready < 0 && errno == EINTR);
 }
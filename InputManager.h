@@ -2,14 +2,21 @@
 #define INPUTMANAGER_H
 
 #include <termios.h>
+#include <string>
 
 class InputManager {
 private:
     termios originalTerminalSettings;
+    std::string pending;
+    long long escapeStarted;
+
+    void readAvailable();
+    bool holdsPartialEscape() const;
 public:
     InputManager();
     ~InputManager();
-    char getInput() const;
+    bool poll(char& key);
+    bool waitForInput(long long timeoutNanos) const;
 };
 
 #endif
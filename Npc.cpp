@@ -1,4 +1,4 @@
 #include "Npc.h"
 using namespace std;
 
-Npc::Npc(int x, int y, const string& icon) : Entity(x, y, icon) {}
+Npc::Npc(int x, int y, GlyphId icon) : Entity(x, y, icon) {}
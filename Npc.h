@@ -5,7 +5,7 @@
 
 class Npc : public Entity {
 public:
-    Npc(int x, int y, const std::string& icon);
+    Npc(int x, int y, GlyphId icon);
 };
 
 #endif
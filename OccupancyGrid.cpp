@@ -0,0 +1,73 @@
+#include "OccupancyGrid.h"
+#include <algorithm>
+using namespace std;
+
+OccupancyGrid::OccupancyGrid(int width, int height)
+    : cells(width, height, BuildingHandle()) {}
+
+Building* OccupancyGrid::at(int x, int y) const {
+    BuildingHandle handle = cells.get(x, y);
+    return handle.isNone() ? nullptr : registry.get(handle);
+}
+
+BuildingHandle OccupancyGrid::handleAt(int x, int y) const {
+    return cells.get(x, y);
+}
+
+// Buildings keep no handle of their own; every placed building has at least one cell inside
+// the grid, and its first such cell holds the handle.
+BuildingHandle OccupancyGrid::handleOf(const Building& building) const {
+    Position pos = building.getPosition();
+    return cells.get(max(pos.x, 0), max(pos.y, 0));
+}
+
+Building* OccupancyGrid::resolve(const BuildingHandle& handle) const {
+    return registry.get(handle);
+}
+
+bool OccupancyGrid::isAreaFree(int x, int y, int sizeX, int sizeY, const Building* ignore) const {
+    BuildingHandle ignored = ignore ? handleOf(*ignore) : BuildingHandle();
+    int xMin = max(x, 0), xMax = min(x + sizeX, cells.getWidth());
+    int yMin = max(y, 0), yMax = min(y + sizeY, cells.getHeight());
+    for (int cy = yMin; cy < yMax; ++cy) {
+        for (int cx = xMin; cx < xMax; ++cx) {
+            BuildingHandle handle = cells.get(cx, cy);
+            if (!handle.isNone() && handle != ignored) return false;
+        }
+    }
+    return true;
+}
+
+// Clearing only touches cells that still hold the building, so removal never allocates a chunk.
+void OccupancyGrid::stamp(const Building& building, const BuildingHandle& value, const BuildingHandle& expected) {
+    Position pos = building.getPosition();
+    int xMin = max(pos.x, 0), xMax = min(pos.x + building.getSizeX(), cells.getWidth());
+    int yMin = max(pos.y, 0), yMax = min(pos.y + building.getSizeY(), cells.getHeight());
+    for (int cy = yMin; cy < yMax; ++cy) {
+        for (int cx = xMin; cx < xMax; ++cx) {
+            if (expected.isNone() || cells.get(cx, cy) == expected) cells.ref(cx, cy) = value;
+        }
+    }
+}
+
+void OccupancyGrid::place(Building* building) {
+    stamp(*building, registry.add(building), BuildingHandle());
+}
+
+void OccupancyGrid::relocate(Building* building) {
+    registry.relocate(handleOf(*building), building);
+}
+
+void OccupancyGrid::remove(Building* building) {
+    BuildingHandle handle = handleOf(*building);
+    stamp(*building, BuildingHandle(), handle);
+    registry.remove(handle);
+}
+
+const BuildingRegistry& OccupancyGrid::getRegistry() const {
+    return registry;
+}
+
+size_t OccupancyGrid::getAllocatedChunks() const {
+    return cells.getAllocatedChunks();
+}
@@ -0,0 +1,44 @@
+#ifndef OCCUPANCYGRID_H
+#define OCCUPANCYGRID_H
+using namespace std;
+#include "Building.h"
+#include "BuildingHandle.h"
+#include "BuildingRegistry.h"
+#include "ChunkedGrid.h"
+
+// Cells hold handles rather than pointers, so a building that moves in memory only updates its
+// registry entry instead of restamping its footprint.
+class OccupancyGrid {
+private:
+    ChunkedGrid<BuildingHandle> cells;
+    BuildingRegistry registry;
+
+    void stamp(const Building& building, const BuildingHandle& value, const BuildingHandle& expected);
+    BuildingHandle handleOf(const Building& building) const;
+
+public:
+    OccupancyGrid(int width, int height);
+    Building* at(int x, int y) const;
+    BuildingHandle handleAt(int x, int y) const;
+    Building* resolve(const BuildingHandle& handle) const;
+    bool isAreaFree(int x, int y, int sizeX, int sizeY, const Building* ignore = nullptr) const;
+    void place(Building* building);
+    void relocate(Building* building);
+    void remove(Building* building);
+    size_t getAllocatedChunks() const;
+    const BuildingRegistry& getRegistry() const;
+
+    // Calls visit(building) once for every building with a cell in the inclusive rectangle. A
+    // building is reported from the first of its cells the rectangle contains, so no set is needed.
+    template <typename F>
+    void forEachBuildingIn(int left, int top, int right, int bottom, F visit) const {
+        cells.forEachAllocated(left, top, right, bottom, [&](int x, int y, const BuildingHandle& handle) {
+            if (handle.isNone()) return;
+            Building* building = registry.get(handle);
+            Position pos = building->getPosition();
+            if (x == max(pos.x, max(left, 0)) && y == max(pos.y, max(top, 0))) visit(building);
+        });
+    }
+};
+
+#endif
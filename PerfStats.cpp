@@ -0,0 +1,47 @@
+#include "PerfStats.h"
+#include <algorithm>
+#include <fstream>
+#include <unistd.h>
+using namespace std;
+
+// Reading /proc costs three syscalls, so the resident size is refreshed at most once a second.
+static const long long RESIDENT_SAMPLE_NANOS = 1000000000LL;
+
+PerfStats::PerfStats() : nextTick(0), residentBytes(0), residentSampledAt(0) {
+    fill(last, last + PERF_PHASE_COUNT, 0);
+    ticks.reserve(TICK_WINDOW);
+}
+
+void PerfStats::record(PerfPhase phase, long long nanos) {
+    last[phase] = nanos;
+    if (phase != PERF_TICK) return;
+    if (ticks.size() < TICK_WINDOW) {
+        ticks.push_back(nanos);
+    } else {
+        ticks[nextTick] = nanos;
+        nextTick = (nextTick + 1) % TICK_WINDOW;
+    }
+}
+
+long long PerfStats::getLast(PerfPhase phase) const {
+    return last[phase];
+}
+
+long long PerfStats::getTickPercentile(int percent) const {
+    if (ticks.empty()) return 0;
+    sorted = ticks;
+    size_t rank = min(sorted.size() - 1, sorted.size() * percent / 100);
+    nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+    return sorted[rank];
+}
+
+long long PerfStats::getResidentBytes() {
+    long long current = GameClock::now();
+    if (residentSampledAt != 0 && current - residentSampledAt < RESIDENT_SAMPLE_NANOS) return residentBytes;
+    residentSampledAt = current;
+
+    ifstream statm("/proc/self/statm");
+    long long totalPages, residentPages;
+    if (statm >> totalPages >> residentPages) residentBytes = residentPages * sysconf(_SC_PAGESIZE);
+    return residentBytes;
+}
@@ -0,0 +1,46 @@
+#ifndef PERFSTATS_H
+#define PERFSTATS_H
+using namespace std;
+#include "GameClock.h"
+#include <vector>
+
+enum PerfPhase { PERF_TICK, PERF_SPAWN, PERF_ENEMIES, PERF_DRAW, PERF_PRESENT, PERF_PHASE_COUNT };
+
+// Phase timings for the performance panel. Each phase keeps its latest duration, and whole ticks
+// are also kept for the last TICK_WINDOW ticks so the panel can show their percentiles.
+class PerfStats {
+private:
+    static const size_t TICK_WINDOW = 256;
+
+    long long last[PERF_PHASE_COUNT];
+    vector<long long> ticks;
+    size_t nextTick;
+    mutable vector<long long> sorted;
+    long long residentBytes;
+    long long residentSampledAt;
+
+public:
+    PerfStats();
+    void record(PerfPhase phase, long long nanos);
+    long long getLast(PerfPhase phase) const;
+    long long getTickPercentile(int percent) const;
+    long long getResidentBytes();
+};
+
+// Times its scope into a phase. With no stats it does nothing, not even read the clock, so the
+// timers can stay in the hot paths when the panel is off.
+class ScopedTimer {
+private:
+    PerfStats* stats;
+    PerfPhase phase;
+    long long start;
+
+public:
+    ScopedTimer(PerfStats* stats, PerfPhase phase)
+        : stats(stats), phase(phase), start(stats ? GameClock::now() : 0) {}
+    ~ScopedTimer() {
+        if (stats) stats->record(phase, GameClock::now() - start);
+    }
+};
+
+#endif
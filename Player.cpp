@@ -1,6 +1,7 @@
 #include "Player.h"
 
-Player::Player(int x, int y) : Entity(x, y, "👷"), resources(400, 400) {}
+Player::Player(int x, int y) : Entity(x, y, GLYPH_PLAYER), resources(400, 400), damage(50) {}
 
 Resources& Player::getResources() { return resources; }
 const Resources& Player::getResources() const { return resources; }
+int Player::getDamage() const { return damage; }
@@ -7,10 +7,12 @@
 class Player : public Entity {
 private:
     Resources resources;
+    int damage;
 public:
     Player(int x, int y);
     Resources& getResources();
     const Resources& getResources() const;
+    int getDamage() const;
 };
 
 #endif
@@ -0,0 +1,99 @@
+#include "Recording.h"
+#include <algorithm>
+using namespace std;
+
+// Layout: "MGRC", version byte, seed u32, width u16, height u16, then one
+// (varint tick delta, command byte) pair per command. A zero command byte ends
+// the stream and is followed by the final board checksum as a u64.
+// Version 2 stores the world size; version 1 stored the terminal size the world used to share.
+// Version 3 checksums the scheduled spawn tick in place of the old spawn counter.
+// Version 4 stops building health at zero, which changes the checksum of runs that end in a loss.
+static const char MAGIC[4] = { 'M', 'G', 'R', 'C' };
+static const unsigned char VERSION = 4;
+
+static void writeFixed(ofstream& out, unsigned long long value, int bytes) {
+    for (int i = 0; i < bytes; ++i) out.put((char)((value >> (i * 8)) & 0xff));
+}
+
+static bool readFixed(ifstream& in, unsigned long long& value, int bytes) {
+    value = 0;
+    for (int i = 0; i < bytes; ++i) {
+        int byte = in.get();
+        if (byte == EOF) return false;
+        value |= (unsigned long long)byte << (i * 8);
+    }
+    return true;
+}
+
+static bool readVarint(ifstream& in, unsigned long long& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int byte = in.get();
+        if (byte == EOF) return false;
+        value |= (unsigned long long)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+InputRecorder::InputRecorder(const string& path, unsigned seed, int width, int height)
+    : out(path.c_str(), ios::binary | ios::trunc), lastTick(0) {
+    out.write(MAGIC, sizeof(MAGIC));
+    out.put((char)VERSION);
+    writeFixed(out, seed, 4);
+    writeFixed(out, width, 2);
+    writeFixed(out, height, 2);
+}
+
+bool InputRecorder::isOpen() const {
+    return out.good();
+}
+
+void InputRecorder::writeVarint(unsigned long long value) {
+    while (value >= 0x80) {
+        out.put((char)((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.put((char)value);
+}
+
+void InputRecorder::record(long long tick, char command) {
+    writeVarint(tick - lastTick);
+    out.put(command);
+    lastTick = tick;
+}
+
+void InputRecorder::finish(long long tick, unsigned long long checksum) {
+    writeVarint(tick - lastTick);
+    out.put(0);
+    writeFixed(out, checksum, 8);
+    out.flush();
+}
+
+bool loadRecording(const string& path, Recording& recording) {
+    ifstream in(path.c_str(), ios::binary);
+    char magic[4];
+    if (!in.read(magic, sizeof(magic)) || !equal(magic, magic + 4, MAGIC)) return false;
+    if (in.get() != VERSION) return false;
+
+    unsigned long long seed, width, height;
+    if (!readFixed(in, seed, 4) || !readFixed(in, width, 2) || !readFixed(in, height, 2)) return false;
+    recording.seed = seed;
+    recording.width = width;
+    recording.height = height;
+    recording.commands.clear();
+
+    long long tick = 0;
+    while (true) {
+        unsigned long long delta;
+        if (!readVarint(in, delta)) return false;
+        tick += delta;
+        int command = in.get();
+        if (command == EOF) return false;
+        if (command == 0) break;
+        RecordedCommand recorded = { tick, (char)command };
+        recording.commands.push_back(recorded);
+    }
+    recording.endTick = tick;
+    return readFixed(in, recording.checksum, 8);
+}
@@ -0,0 +1,37 @@
+#ifndef RECORDING_H
+#define RECORDING_H
+using namespace std;
+#include <fstream>
+#include <string>
+#include <vector>
+
+struct RecordedCommand {
+    long long tick;
+    char command;
+};
+
+struct Recording {
+    unsigned seed;
+    int width;
+    int height;
+    vector<RecordedCommand> commands;
+    long long endTick;
+    unsigned long long checksum;
+};
+
+class InputRecorder {
+private:
+    ofstream out;
+    long long lastTick;
+
+    void writeVarint(unsigned long long value);
+public:
+    InputRecorder(const string& path, unsigned seed, int width, int height);
+    bool isOpen() const;
+    void record(long long tick, char command);
+    void finish(long long tick, unsigned long long checksum);
+};
+
+bool loadRecording(const string& path, Recording& recording);
+
+#endif
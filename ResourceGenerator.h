@@ -3,15 +3,34 @@
 using namespace std;
 #include "Building.h"
 
-class ResourceGenerator : public Building {
+// A generator fills at a fixed rate from the tick it was last emptied, so its amount is a closed
+// form of the current tick and nothing has to run while it sits idle. Capacity and rate come
+// from the type's traits, so the only per-instance state added is the tick it was emptied.
+template <BuildingType Type>
+class ResourceGenerator : public TypedBuilding<Type> {
 protected:
-    int currentAmount;
-    const int capacity;
+    typedef BuildingTraits<Type> Traits;
+    long long emptiedAt;
 public:
-    ResourceGenerator(int x, int y, int sizeX, int sizeY, int costGold, int costElixir,
-                     int health, int maxInstances, const string& icon, int capacity);
-    virtual void update() = 0;
-    virtual int collect() = 0;
+    ResourceGenerator(int x, int y, long long placedAt) : TypedBuilding<Type>(x, y), emptiedAt(placedAt) {}
+
+    long long getEmptiedAt() const { return emptiedAt; }
+
+    int getCurrentAmount(long long tick) const {
+        long long filled = (tick - emptiedAt) * Traits::rate;
+        return filled < Traits::capacity ? (int)filled : Traits::capacity;
+    }
+
+    bool isFull(long long tick) const { return getCurrentAmount(tick) >= Traits::capacity; }
+
+    GlyphId getIconAt(long long tick) const { return isFull(tick) ? Traits::fullIcon : Traits::icon; }
+
+    // Only a full generator can be emptied.
+    int collect(long long tick) {
+        if (!isFull(tick)) return 0;
+        emptiedAt = tick;
+        return Traits::capacity;
+    }
 };
 
 #endif
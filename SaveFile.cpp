@@ -0,0 +1,271 @@
+#include "SaveFile.h"
+#include "Board.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+using namespace std;
+
+static const char MAGIC[4] = { 'M', 'G', 'S', 'V' };
+static const uint32_t VERSION = 1;
+static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+static_assert(sizeof(SaveHeader) % 8 == 0, "records after the header must stay 8-byte aligned");
+static_assert(sizeof(SavedBuilding) == 24, "SavedBuilding is part of the file format");
+static_assert(sizeof(SavedEnemy) == 24, "SavedEnemy is part of the file format");
+
+static SavedBuilding saveBuilding(const Building& building, long long emptiedAt) {
+    SavedBuilding saved = { building.getPosition().x, building.getPosition().y, building.getHealth(), 0, emptiedAt };
+    return saved;
+}
+
+template <typename T>
+static void writeRecords(ofstream& out, const vector<T>& records) {
+    out.write((const char*)records.data(), records.size() * sizeof(T));
+}
+
+bool saveBoard(const Board& board, const string& path) {
+    SaveHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.seed = board.seed;
+    header.width = board.width;
+    header.height = board.height;
+    header.tick = board.tick;
+    header.nextSpawn = board.nextSpawn;
+    header.enemyLastUpdate = board.enemies.lastUpdate;
+    header.playerX = board.player.getPosition().x;
+    header.playerY = board.player.getPosition().y;
+    header.gold = board.player.getResources().gold;
+    header.elixir = board.player.getResources().elixir;
+    header.anchorX = board.anchor.x;
+    header.anchorY = board.anchor.y;
+    header.hasAnchor = board.hasAnchor;
+    header.gameOver = board.gameOver;
+    header.townHallHealth = board.townhall.getHealth();
+
+    // The generator's own text form is the only portable way to read its state back out.
+    stringstream rngState;
+    rngState << board.rng;
+    uint32_t word;
+    while (header.rngWordCount < SAVE_RNG_WORDS && rngState >> word) header.rng[header.rngWordCount++] = word;
+
+    vector<SavedBuilding> walls, goldMines, elixirCollectors;
+    for (const auto& wall : board.walls) walls.push_back(saveBuilding(wall, 0));
+    for (const auto& mine : board.goldMines) goldMines.push_back(saveBuilding(mine, mine.getEmptiedAt()));
+    for (const auto& collector : board.elixirCollectors) {
+        elixirCollectors.push_back(saveBuilding(collector, collector.getEmptiedAt()));
+    }
+
+    const EnemyPool& pool = board.enemies;
+    vector<SavedEnemy> enemies(pool.slotCount());
+    for (size_t i = 0; i < enemies.size(); ++i) {
+        SavedEnemy saved = { pool.x[i], pool.y[i], pool.health[i], pool.state[i], pool.kind[i], pool.alive[i], 0, pool.wakeAt[i] };
+        enemies[i] = saved;
+    }
+    vector<uint32_t> freeSlots(pool.freeSlots.begin(), pool.freeSlots.end());
+    // The field is saved rather than rebuilt: repairs keep the costs walls had when they went up
+    // and can break ties differently, so only the field itself continues the run exactly.
+    const FlowField& field = board.flowField;
+    vector<int32_t> distance(field.distance.begin(), field.distance.end());
+    vector<int32_t> next(field.next.begin(), field.next.end());
+    vector<int32_t> cost(field.cost.begin(), field.cost.end());
+
+    header.wallCount = walls.size();
+    header.goldMineCount = goldMines.size();
+    header.elixirCollectorCount = elixirCollectors.size();
+    header.enemySlotCount = enemies.size();
+    header.freeSlotCount = freeSlots.size();
+    header.fieldCellCount = distance.size();
+
+    // Written beside the target and renamed over it, so a failed save never clobbers the last good one.
+    string temporary = path + ".tmp";
+    ofstream out(temporary.c_str(), ios::binary | ios::trunc);
+    out.write((const char*)&header, sizeof(header));
+    writeRecords(out, walls);
+    writeRecords(out, goldMines);
+    writeRecords(out, elixirCollectors);
+    writeRecords(out, enemies);
+    writeRecords(out, distance);
+    writeRecords(out, next);
+    writeRecords(out, cost);
+    writeRecords(out, freeSlots);
+    out.close();
+    if (!out || rename(temporary.c_str(), path.c_str()) != 0) {
+        remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+static const SaveHeader* checkHeader(const char* data, size_t length) {
+    if (length < sizeof(SaveHeader)) return nullptr;
+    const SaveHeader* header = (const SaveHeader*)data;
+    if (memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->version != VERSION ||
+        header->byteOrder != BYTE_ORDER_MARK || header->rngWordCount > SAVE_RNG_WORDS ||
+        header->width < MIN_WORLD_WIDTH || header->height < MIN_WORLD_HEIGHT ||
+        header->width > MAX_WORLD_SIZE || header->height > MAX_WORLD_SIZE) return nullptr;
+
+    unsigned long long expected = sizeof(SaveHeader)
+        + ((unsigned long long)header->wallCount + header->goldMineCount + header->elixirCollectorCount) * sizeof(SavedBuilding)
+        + (unsigned long long)header->enemySlotCount * sizeof(SavedEnemy)
+        + (unsigned long long)header->fieldCellCount * 3 * sizeof(int32_t)
+        + (unsigned long long)header->freeSlotCount * sizeof(uint32_t);
+    return expected == length ? header : nullptr;
+}
+
+template <typename T>
+static T makeBuilding(const SavedBuilding& saved) { return T(saved.x, saved.y, saved.emptiedAt); }
+
+template <>
+Wall makeBuilding<Wall>(const SavedBuilding& saved) { return Wall(saved.x, saved.y); }
+
+// CanBuild clips footprints to the grid, so a building must also be shown to cover at least one
+// cell of the world: the occupancy grid finds a building's handle through its first such cell.
+template <typename T>
+static bool isInWorld(const SavedBuilding& saved, const Board& board) {
+    return saved.x > -T::getSizeX() && saved.y > -T::getSizeY() &&
+           saved.x < board.getWidth() && saved.y < board.getHeight();
+}
+
+// Reserving up front means no element moves, so each building is registered exactly once.
+template <typename T>
+static bool restoreBuildings(vector<T>& buildings, const SavedBuilding* saved, size_t count,
+                             const Board& board, OccupancyGrid& occupancy) {
+    buildings.reserve(max(buildings.capacity(), count));
+    for (size_t i = 0; i < count; ++i) {
+        if (!isInWorld<T>(saved[i], board)) return false;
+        T building = makeBuilding<T>(saved[i]);
+        if (saved[i].health <= 0 || saved[i].health > building.getHealth()) return false;
+        building.takeDamage(building.getHealth() - saved[i].health);
+        if (!board.CanBuild(building)) return false;
+        buildings.push_back(building);
+        occupancy.place(&buildings.back());
+    }
+    return true;
+}
+
+// The whole file is mapped read-only; records are read in place and the mapping is dropped on return.
+class MappedFile {
+private:
+    void* data;
+    size_t length;
+
+public:
+    MappedFile(const string& path) : data(MAP_FAILED), length(0) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        struct stat info;
+        if (fstat(fd, &info) == 0 && info.st_size > 0) {
+            length = info.st_size;
+            data = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        close(fd);
+    }
+    ~MappedFile() {
+        if (data != MAP_FAILED) munmap(data, length);
+    }
+    const char* getData() const { return data == MAP_FAILED ? nullptr : (const char*)data; }
+    size_t getLength() const { return length; }
+};
+
+// The per-record work is placing buildings in the occupancy grid and rescheduling enemies.
+// Enemy targets are not saved: an attacker stands on its building and finds it again on its next turn.
+unique_ptr<Board> loadBoard(const string& path, int viewWidth, int viewHeight) {
+    MappedFile file(path);
+    if (!file.getData()) return nullptr;
+    const SaveHeader* saved = checkHeader(file.getData(), file.getLength());
+    if (!saved) return nullptr;
+    const SaveHeader& header = *saved;
+    const char* records = file.getData() + sizeof(SaveHeader);
+    unique_ptr<Board> loaded(new Board(header.width, header.height, header.seed, viewWidth, viewHeight));
+    Board& board = *loaded;
+
+    if (header.playerX < 0 || header.playerY < 0 || header.playerX >= board.width || header.playerY >= board.height) return nullptr;
+    board.player.setPosition(header.playerX, header.playerY);
+    board.player.getResources().gold = header.gold;
+    board.player.getResources().elixir = header.elixir;
+    board.hasAnchor = header.hasAnchor;
+    board.anchor = Position(header.anchorX, header.anchorY);
+    board.gameOver = header.gameOver;
+    board.tick = header.tick;
+    board.nextSpawn = header.nextSpawn;
+    if (header.townHallHealth < 0 || header.townHallHealth > board.townhall.getHealth()) return nullptr;
+    board.townhall.takeDamage(board.townhall.getHealth() - header.townHallHealth);
+
+    stringstream rngState;
+    for (uint32_t i = 0; i < header.rngWordCount; ++i) rngState << header.rng[i] << ' ';
+    if (!(rngState >> board.rng)) return nullptr;
+
+    const SavedBuilding* buildings = (const SavedBuilding*)records;
+    if (!restoreBuildings(board.walls, buildings, header.wallCount, board, board.occupancy)) return nullptr;
+    buildings += header.wallCount;
+    if (!restoreBuildings(board.goldMines, buildings, header.goldMineCount, board, board.occupancy)) return nullptr;
+    buildings += header.goldMineCount;
+    if (!restoreBuildings(board.elixirCollectors, buildings, header.elixirCollectorCount, board, board.occupancy)) return nullptr;
+    buildings += header.elixirCollectorCount;
+
+    // The wheel restarts at the saved tick holding only live timers; the stale ones it dropped
+    // would have been ignored when they fired anyway.
+    board.timers = TimerWheel(header.tick);
+    board.timers.schedule(header.nextSpawn, TIMER_SPAWN, 0);
+
+    EnemyPool& pool = board.enemies;
+    const SavedEnemy* enemies = (const SavedEnemy*)buildings;
+    size_t slots = header.enemySlotCount;
+    pool.x.resize(slots);
+    pool.y.resize(slots);
+    pool.health.resize(slots);
+    pool.wakeAt.resize(slots);
+    pool.state.resize(slots);
+    pool.kind.resize(slots);
+    pool.alive.resize(slots);
+    pool.target.assign(slots, BuildingHandle());
+    pool.liveCount = 0;
+    pool.lastUpdate = header.enemyLastUpdate;
+    for (size_t i = 0; i < slots; ++i) {
+        const SavedEnemy& enemy = enemies[i];
+        if (enemy.kind >= ENEMY_KIND_COUNT || enemy.state > EnemyPool::ATTACKING) return nullptr;
+        pool.x[i] = enemy.x;
+        pool.y[i] = enemy.y;
+        pool.health[i] = enemy.health;
+        pool.wakeAt[i] = enemy.wakeAt;
+        pool.state[i] = enemy.state;
+        pool.kind[i] = enemy.kind;
+        pool.alive[i] = enemy.alive != 0;
+        if (!pool.alive[i]) continue;
+        if (enemy.x < 0 || enemy.y < 0 || enemy.x >= board.width || enemy.y >= board.height) return nullptr;
+        ++pool.liveCount;
+        board.timers.schedule(enemy.wakeAt, TIMER_ENEMY, i);
+    }
+
+    FlowField& field = board.flowField;
+    size_t cells = header.fieldCellCount;
+    if (cells != field.distance.size()) return nullptr;
+    const int32_t* distance = (const int32_t*)(enemies + slots);
+    const int32_t* next = distance + cells;
+    const int32_t* cost = next + cells;
+    for (size_t i = 0; i < cells; ++i) {
+        if (next[i] < -1 || next[i] >= (int)cells) return nullptr;
+    }
+    field.distance.assign(distance, next);
+    field.next.assign(next, cost);
+    field.cost.assign(cost, cost + cells);
+
+    const uint32_t* freeSlots = (const uint32_t*)(cost + cells);
+    pool.freeSlots.assign(freeSlots, freeSlots + header.freeSlotCount);
+    // A slot listed twice would be handed to two enemies by spawn, so each may appear once, and
+    // only if it is in range and dead.
+    vector<unsigned char> listed(slots, 0);
+    for (size_t slot : pool.freeSlots) {
+        if (slot >= slots || pool.alive[slot] || listed[slot]) return nullptr;
+        listed[slot] = 1;
+    }
+    return loaded;
+}
@@ -0,0 +1,64 @@
+#ifndef SAVEFILE_H
+#define SAVEFILE_H
+using namespace std;
+#include <cstdint>
+#include <memory>
+#include <string>
+
+class Board;
+
+// A save is one SaveHeader followed by flat arrays of fixed-width records, in this order: walls,
+// gold mines, elixir collectors, enemy slots, the flow field's distance, next and cost arrays as
+// int32 per battlefield cell, then the enemy free list as uint32 slot numbers. Every record is
+// aligned to its widest field, so a loader can map the file and index straight into it.
+static const int SAVE_RNG_WORDS = 625;
+
+struct SaveHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t seed;
+    int32_t width;
+    int32_t height;
+    int64_t tick;
+    int64_t nextSpawn;
+    int64_t enemyLastUpdate;
+    int32_t playerX, playerY;
+    int32_t gold, elixir;
+    int32_t anchorX, anchorY;
+    uint8_t hasAnchor;
+    uint8_t gameOver;
+    uint8_t reserved[2];
+    int32_t townHallHealth;
+    uint32_t wallCount;
+    uint32_t goldMineCount;
+    uint32_t elixirCollectorCount;
+    uint32_t enemySlotCount;
+    uint32_t freeSlotCount;
+    uint32_t fieldCellCount;
+    // The board's mt19937 state as binary words: the 624 state words and the position the engine
+    // reached. The standard only exposes engine state through its stream operators, so the words
+    // are read out of and fed back through that text form, but the file stores them in binary.
+    uint32_t rngWordCount;
+    uint32_t rng[SAVE_RNG_WORDS];
+    uint32_t padding;
+};
+
+struct SavedBuilding {
+    int32_t x, y;
+    int32_t health;
+    int32_t reserved;
+    int64_t emptiedAt;
+};
+
+struct SavedEnemy {
+    int32_t x, y;
+    int32_t health;
+    uint8_t state, kind, alive, reserved;
+    int64_t wakeAt;
+};
+
+bool saveBoard(const Board& board, const string& path);
+unique_ptr<Board> loadBoard(const string& path, int viewWidth = 147, int viewHeight = 33);
+
+#endif
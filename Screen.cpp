@@ -0,0 +1,117 @@
+#include "Screen.h"
+#include <unistd.h>
+using namespace std;
+
+Screen::Screen(int width, int height)
+    : width(width), height(height), fd(STDOUT_FILENO),
+      front(width * height, GLYPH_SPACE),
+      back(width * height, GLYPH_SPACE),
+      fullRedraw(true),
+      frameBytes(0),
+      frameWrites(0),
+      encoder(width) {}
+
+int Screen::getWidth() const { return width; }
+int Screen::getHeight() const { return height; }
+
+GlyphId& Screen::at(int x, int y) {
+    return back[(y - 1) * width + (x - 1)];
+}
+
+void Screen::breakWideGlyph(int x, int y) {
+    int cellWidth = getGlyph(at(x, y)).width;
+    if (cellWidth == 0 && x > 1) {
+        at(x - 1, y) = GLYPH_SPACE;
+    } else if (cellWidth == 2 && x < width) {
+        at(x + 1, y) = GLYPH_SPACE;
+    }
+}
+
+void Screen::clear() {
+    fill(back.begin(), back.end(), GLYPH_SPACE);
+}
+
+void Screen::put(int x, int y, GlyphId glyph) {
+    if (glyph == GLYPH_CONTINUATION || x < 1 || y < 1 || x > width || y > height) return;
+
+    bool wide = getGlyph(glyph).width == 2;
+    if (wide && x == width) return;
+
+    breakWideGlyph(x, y);
+    if (wide) breakWideGlyph(x + 1, y);
+
+    at(x, y) = glyph;
+    if (wide) at(x + 1, y) = GLYPH_CONTINUATION;
+}
+
+// Text is ASCII, which interns to the byte itself.
+void Screen::putText(int x, int y, const string& text) {
+    for (size_t i = 0; i < text.size(); ++i) {
+        unsigned char c = text[i];
+        put(x + i, y, c < 128 ? c : '?');
+    }
+}
+
+void Screen::invalidate() {
+    fullRedraw = true;
+}
+
+void Screen::setOutput(int outputFd) {
+    fd = outputFd;
+    fullRedraw = true;
+}
+
+void Screen::present() {
+    encoder.beginFrame();
+    if (fullRedraw) encoder.clearScreen();
+
+    bool changed = fullRedraw;
+    for (int y = 1; y <= height; ++y) {
+        for (int x = 1; x <= width; ++x) {
+            int index = (y - 1) * width + (x - 1);
+            // Continuation cells are repainted by the wide glyph that owns them.
+            if (back[index] == GLYPH_CONTINUATION) continue;
+            if (!fullRedraw && back[index] == front[index]) continue;
+
+            const GlyphInfo& glyph = getGlyph(back[index]);
+            moveCursor(x, y);
+            encoder.write(glyph.bytes, glyph.length, glyph.width);
+            changed = true;
+        }
+    }
+    encoder.endFrame();
+
+    frameBytes = 0;
+    frameWrites = 0;
+    if (changed) {
+        encoder.flush(fd);
+        frameBytes = encoder.size();
+        frameWrites = encoder.getWrites();
+    }
+
+    front = back;
+    fullRedraw = false;
+}
+
+// What the last present wrote; a frame with no changes writes nothing.
+size_t Screen::getFrameBytes() const { return frameBytes; }
+int Screen::getFrameWrites() const { return frameWrites; }
+
+void Screen::moveCursor(int x, int y) {
+    int fromX = encoder.getCursorX();
+    if (encoder.getCursorY() == y && fromX > 0 && fromX < x) {
+        // Cells between the cursor and the target are unchanged, so re-sending them may be cheaper than a motion.
+        int rowStart = (y - 1) * width;
+        int runCost = 0;
+        for (int i = fromX; i < x; ++i) runCost += getGlyph(back[rowStart + i - 1]).length;
+
+        if (runCost <= encoder.moveCost(x, y)) {
+            for (int i = fromX; i < x; ++i) {
+                const GlyphInfo& glyph = getGlyph(back[rowStart + i - 1]);
+                if (glyph.width > 0) encoder.write(glyph.bytes, glyph.length, glyph.width);
+            }
+            return;
+        }
+    }
+    encoder.moveTo(x, y);
+}
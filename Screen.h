@@ -0,0 +1,39 @@
+#ifndef SCREEN_H
+#define SCREEN_H
+using namespace std;
+#include "FrameEncoder.h"
+#include "Glyph.h"
+#include <string>
+#include <vector>
+
+class Screen {
+private:
+    int width;
+    int height;
+    int fd;
+    vector<GlyphId> front;
+    vector<GlyphId> back;
+    bool fullRedraw;
+    size_t frameBytes;
+    int frameWrites;
+    FrameEncoder encoder;
+
+    GlyphId& at(int x, int y);
+    void breakWideGlyph(int x, int y);
+    void moveCursor(int x, int y);
+
+public:
+    Screen(int width, int height);
+    int getWidth() const;
+    int getHeight() const;
+    void clear();
+    void put(int x, int y, GlyphId glyph);
+    void putText(int x, int y, const string& text);
+    void invalidate();
+    void setOutput(int fd);
+    void present();
+    size_t getFrameBytes() const;
+    int getFrameWrites() const;
+};
+
+#endif
@@ -0,0 +1,240 @@
+#include "Server.h"
+#include "Board.h"
+#include "GameClock.h"
+#include "SaveFile.h"
+#include "StateStream.h"
+#include "Tracer.h"
+#include <cctype>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+using namespace std;
+
+// A viewer this far behind has its queued deltas dropped and is sent one full state instead, so a
+// slow terminal only ever costs its own frames.
+static const size_t MAX_BACKLOG = 4 << 20;
+static const long long DRAIN_NANOS = 1000000000LL;
+
+static volatile sig_atomic_t stopRequested = 0;
+
+static void requestStop(int) {
+    stopRequested = 1;
+}
+
+struct RemoteViewer {
+    int fd;
+    deque<shared_ptr<const string> > queue;
+    size_t sent;
+    size_t queued;
+    bool needsFull;
+    bool closed;
+    bool greeted;
+};
+
+static void queueMessage(RemoteViewer& viewer, const shared_ptr<const string>& message) {
+    // A half-written message has to finish or the stream loses its framing, and a viewer only
+    // sets up its view on HELLO, so an unsent HELLO stays queued as well.
+    size_t keep = !viewer.queue.empty() && (viewer.sent > 0 || !viewer.greeted) ? 1 : 0;
+    size_t kept = keep ? viewer.queue.front()->size() - viewer.sent : 0;
+    if (viewer.queued > kept && viewer.queued + message->size() > MAX_BACKLOG) {
+        while (viewer.queue.size() > keep) {
+            viewer.queued -= viewer.queue.back()->size();
+            viewer.queue.pop_back();
+        }
+        viewer.needsFull = true;
+        return;
+    }
+    viewer.queue.push_back(message);
+    viewer.queued += message->size();
+}
+
+// Writes whatever the socket takes without blocking; the rest waits for the next POLLOUT.
+static void flushViewer(RemoteViewer& viewer) {
+    while (!viewer.closed && !viewer.queue.empty()) {
+        const string& front = *viewer.queue.front();
+        ssize_t written = send(viewer.fd, front.data() + viewer.sent, front.size() - viewer.sent,
+                               MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (written < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) viewer.closed = true;
+            return;
+        }
+        viewer.sent += written;
+        viewer.queued -= written;
+        if (viewer.sent == front.size()) {
+            viewer.queue.pop_front();
+            viewer.sent = 0;
+            viewer.greeted = true;
+        }
+    }
+}
+
+// Commands are single bytes, applied in the order they arrive between ticks.
+static bool readCommands(RemoteViewer& viewer, Board& board) {
+    bool applied = false;
+    char buffer[256];
+    while (true) {
+        ssize_t count = recv(viewer.fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+        if (count == 0 || (count < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+            viewer.closed = true;
+            return applied;
+        }
+        if (count < 0) return applied;
+        for (ssize_t i = 0; i < count; ++i) {
+            if (board.applyCommand(toupper(buffer[i]))) applied = true;
+        }
+    }
+}
+
+// One delta is encoded per change and shared by every viewer that is in step; viewers that are
+// new or were dropped behind get a full state of the same snapshot instead.
+static void broadcast(const Board& board, vector<RemoteViewer>& viewers, StateSnapshot& previous,
+                      StateSnapshot& current, bool changed) {
+    shared_ptr<string> delta;
+    if (changed) {
+        captureState(board, current);
+        string body;
+        encodeState(&previous, current, body);
+        swap(previous, current);
+        delta = make_shared<string>();
+        appendMessage(*delta, MESSAGE_STATE, body);
+    }
+
+    shared_ptr<string> full;
+    for (RemoteViewer& viewer : viewers) {
+        if (viewer.needsFull) {
+            if (!full) {
+                string body;
+                encodeState(nullptr, previous, body);
+                full = make_shared<string>();
+                appendMessage(*full, MESSAGE_STATE, body);
+            }
+            viewer.needsFull = false;
+            queueMessage(viewer, full);
+        } else if (delta) {
+            queueMessage(viewer, delta);
+        }
+    }
+}
+
+static void acceptViewers(int listener, const Board& board, vector<RemoteViewer>& viewers) {
+    while (true) {
+        int fd = accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;
+        RemoteViewer viewer = { fd, deque<shared_ptr<const string> >(), 0, 0, true, false, false };
+        string body;
+        encodeHello(board.getWidth(), board.getHeight(), body);
+        shared_ptr<string> hello = make_shared<string>();
+        appendMessage(*hello, MESSAGE_HELLO, body);
+        queueMessage(viewer, hello);
+        viewers.push_back(viewer);
+    }
+}
+
+static int openListener(const string& path) {
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) return -1;
+    memcpy(address.sun_path, path.c_str(), path.size());
+
+    int listener = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listener < 0) return -1;
+    unlink(path.c_str());
+    if (bind(listener, (sockaddr*)&address, sizeof(address)) != 0 || listen(listener, SOMAXCONN) != 0) {
+        close(listener);
+        return -1;
+    }
+    return listener;
+}
+
+// The board only ever runs here. Viewers send key bytes and receive the state stream; none of
+// them can hold up a tick, since every socket is non-blocking and a stalled viewer is resynced.
+int runServer(const ServerOptions& options) {
+    unique_ptr<Board> loaded;
+    if (options.loadPath.empty()) {
+        loaded.reset(new Board(options.width, options.height, options.seed));
+    } else if (!(loaded = loadBoard(options.loadPath))) {
+        cerr << "cannot load save " << options.loadPath << endl;
+        return 1;
+    }
+    Board& board = *loaded;
+    if (options.threads > 0) board.setThreadCount(options.threads);
+
+    int listener = openListener(options.socketPath);
+    if (listener < 0) {
+        cerr << "cannot listen on " << options.socketPath << ": " << strerror(errno) << endl;
+        return 1;
+    }
+    signal(SIGINT, requestStop);
+    signal(SIGTERM, requestStop);
+
+    StateSnapshot previous, current;
+    captureState(board, previous);
+    vector<RemoteViewer> viewers;
+    vector<pollfd> fds;
+    GameClock clock(options.ticksPerSecond);
+    long long endTick = board.getTick() + options.ticks;
+
+    while (!stopRequested && board.getTick() < endTick && !board.isGameOver()) {
+        fds.clear();
+        pollfd listening = { listener, POLLIN, 0 };
+        fds.push_back(listening);
+        for (const RemoteViewer& viewer : viewers) {
+            pollfd entry = { viewer.fd, (short)(POLLIN | (viewer.queue.empty() ? 0 : POLLOUT)), 0 };
+            fds.push_back(entry);
+        }
+        long long wait = max(0LL, clock.nanosUntilDeadline());
+        timespec timeout = { (time_t)(wait / 1000000000LL), (long)(wait % 1000000000LL) };
+        ppoll(fds.data(), fds.size(), &timeout, nullptr);
+
+        bool changed = false;
+        for (size_t i = 0; i < viewers.size(); ++i) {
+            if (fds[i + 1].revents & (POLLIN | POLLHUP | POLLERR)) changed |= readCommands(viewers[i], board);
+        }
+        if (fds[0].revents & POLLIN) acceptViewers(listener, board, viewers);
+        while (clock.due() && board.getTick() < endTick && !board.isGameOver()) {
+            board.update();
+            Tracer::flushIfRequested();
+            changed = true;
+        }
+
+        broadcast(board, viewers, previous, current, changed);
+        size_t kept = 0;
+        for (RemoteViewer& viewer : viewers) {
+            flushViewer(viewer);
+            if (viewer.closed) {
+                close(viewer.fd);
+                continue;
+            }
+            viewers[kept++] = viewer;
+        }
+        viewers.resize(kept);
+    }
+
+    // Viewers get a bounded moment to take the final state before the connections close.
+    broadcast(board, viewers, previous, current, true);
+    long long drainUntil = GameClock::now() + DRAIN_NANOS;
+    for (RemoteViewer& viewer : viewers) {
+        while (!viewer.closed && !viewer.queue.empty() && GameClock::now() < drainUntil) {
+            pollfd entry = { viewer.fd, POLLOUT, 0 };
+            poll(&entry, 1, 10);
+            flushViewer(viewer);
+        }
+        close(viewer.fd);
+    }
+    close(listener);
+    unlink(options.socketPath.c_str());
+
+    cout << "ticks=" << board.getTick() << endl;
+    cout << board.describeState() << endl;
+    cout << previous.describe() << endl;
+    return 0;
+}
@@ -0,0 +1,19 @@
+#ifndef SERVER_H
+#define SERVER_H
+using namespace std;
+#include <string>
+
+struct ServerOptions {
+    string socketPath;
+    long long ticks;
+    int ticksPerSecond;
+    unsigned seed;
+    int threads;
+    int width;
+    int height;
+    string loadPath;
+};
+
+int runServer(const ServerOptions& options);
+
+#endif
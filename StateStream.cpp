@@ -0,0 +1,434 @@
+#include "StateStream.h"
+#include "Board.h"
+#include <algorithm>
+#include <sstream>
+using namespace std;
+
+enum ScalarBits { SCALAR_PLAYER = 1, SCALAR_RESOURCES = 2, SCALAR_ANCHOR = 4, SCALAR_GAME_OVER = 8 };
+static const unsigned char STATE_RESET = 1;
+static const unsigned long long MAX_ENEMY_SLOTS = 1 << 24;
+// A full state of the largest world fits well inside this; anything longer is a corrupt prefix.
+static const unsigned long long MAX_MESSAGE_LENGTH = 1ULL << 28;
+static const int MAX_VARINT_BYTES = 10;
+
+StateSnapshot::StateSnapshot()
+    : tick(0), playerX(0), playerY(0), gold(0), elixir(0), anchorX(0), anchorY(0),
+      hasAnchor(false), gameOver(false) {}
+
+size_t StateSnapshot::countBuildings(int type) const {
+    size_t count = 0;
+    for (const BuildingState& building : buildings) count += building.type == type;
+    return count;
+}
+
+size_t StateSnapshot::countEnemies() const {
+    size_t count = 0;
+    for (const EnemyState& enemy : enemies) count += enemy.alive;
+    return count;
+}
+
+static void mix(unsigned long long& hash, long long value) {
+    for (int i = 0; i < 8; ++i) {
+        hash ^= (value >> (i * 8)) & 0xff;
+        hash *= 1099511628211ULL;
+    }
+}
+
+// FNV-1a over every field, so a client can prove its copy matches the server's.
+unsigned long long StateSnapshot::checksum() const {
+    unsigned long long hash = 14695981039346656037ULL;
+    mix(hash, tick);
+    mix(hash, playerX);
+    mix(hash, playerY);
+    mix(hash, gold);
+    mix(hash, elixir);
+    mix(hash, anchorX);
+    mix(hash, anchorY);
+    mix(hash, hasAnchor);
+    mix(hash, gameOver);
+    for (const BuildingState& building : buildings) {
+        mix(hash, building.slot);
+        mix(hash, building.x);
+        mix(hash, building.y);
+        mix(hash, building.health);
+        mix(hash, building.type);
+        mix(hash, building.icon);
+        mix(hash, building.sizeX);
+        mix(hash, building.sizeY);
+        mix(hash, building.border);
+    }
+    for (const EnemyState& enemy : enemies) {
+        mix(hash, enemy.x);
+        mix(hash, enemy.y);
+        mix(hash, enemy.kind);
+        mix(hash, enemy.alive);
+    }
+    return hash;
+}
+
+int StateSnapshot::getTownHallHealth() const {
+    for (const BuildingState& building : buildings) {
+        if (building.type == TOWN_HALL) return building.health;
+    }
+    return 0;
+}
+
+string StateSnapshot::describe() const {
+    ostringstream out;
+    out << "tick=" << tick
+        << " gold=" << gold
+        << " elixir=" << elixir
+        << " walls=" << countBuildings(WALL)
+        << " goldMines=" << countBuildings(GOLD_MINE)
+        << " elixirCollectors=" << countBuildings(ELIXIR_COLLECTOR)
+        << " townHallHP=" << getTownHallHealth()
+        << " enemies=" << countEnemies()
+        << " gameOver=" << (gameOver ? "yes" : "no")
+        << " checksum=" << hex << checksum() << dec;
+    return out.str();
+}
+
+static StateSnapshot::BuildingState captureBuilding(const Building& building, unsigned slot, long long tick) {
+    GlyphId icon = building.getIcon();
+    if (building.getType() == GOLD_MINE) icon = static_cast<const GoldMine&>(building).getIconAt(tick);
+    if (building.getType() == ELIXIR_COLLECTOR) icon = static_cast<const ElixirCollector&>(building).getIconAt(tick);
+    StateSnapshot::BuildingState state = {
+        slot, building.getPosition().x, building.getPosition().y, building.getHealth(),
+        (unsigned char)building.getType(), icon,
+        (unsigned char)building.getSizeX(), (unsigned char)building.getSizeY(), building.Border()
+    };
+    return state;
+}
+
+static bool buildingBefore(const StateSnapshot::BuildingState& a, const StateSnapshot::BuildingState& b) {
+    if (a.type != b.type) return a.type < b.type;
+    return a.slot < b.slot;
+}
+
+void captureState(const Board& board, StateSnapshot& snapshot) {
+    snapshot.tick = board.tick;
+    snapshot.playerX = board.player.getPosition().x;
+    snapshot.playerY = board.player.getPosition().y;
+    snapshot.gold = board.player.getResources().gold;
+    snapshot.elixir = board.player.getResources().elixir;
+    snapshot.anchorX = board.anchor.x;
+    snapshot.anchorY = board.anchor.y;
+    snapshot.hasAnchor = board.hasAnchor;
+    snapshot.gameOver = board.gameOver;
+
+    // The registry is walked in slot order and each building goes to the next place in its type's
+    // range, so the list comes out in key order in one pass, without sorting.
+    size_t next[ELIXIR_COLLECTOR + 1];
+    next[TOWN_HALL] = 0;
+    next[WALL] = 1;
+    next[GOLD_MINE] = next[WALL] + board.walls.size();
+    next[ELIXIR_COLLECTOR] = next[GOLD_MINE] + board.goldMines.size();
+    vector<StateSnapshot::BuildingState>& buildings = snapshot.buildings;
+    buildings.resize(next[ELIXIR_COLLECTOR] + board.elixirCollectors.size());
+    const BuildingRegistry& registry = board.occupancy.getRegistry();
+    for (size_t slot = 0; slot < registry.slotCount(); ++slot) {
+        const Building* building = registry.at(slot);
+        if (building) buildings[next[building->getType()]++] = captureBuilding(*building, slot, board.tick);
+    }
+
+    const EnemyPool& pool = board.enemies;
+    snapshot.enemies.resize(pool.slotCount());
+    for (size_t i = 0; i < pool.slotCount(); ++i) {
+        StateSnapshot::EnemyState& enemy = snapshot.enemies[i];
+        enemy.alive = pool.isAlive(i);
+        enemy.kind = enemy.alive ? pool.kind[i] : 0;
+        enemy.x = enemy.alive ? pool.getX(i) : 0;
+        enemy.y = enemy.alive ? pool.getY(i) : 0;
+    }
+}
+
+static void writeVarint(string& out, unsigned long long value) {
+    while (value >= 0x80) {
+        out.push_back((char)((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.push_back((char)value);
+}
+
+// Zigzag keeps small negative offsets to one byte.
+static void writeSigned(string& out, long long value) {
+    writeVarint(out, ((unsigned long long)value << 1) ^ (unsigned long long)(value >> 63));
+}
+
+static void writeBuildingKey(string& out, const StateSnapshot::BuildingState& building) {
+    out.push_back((char)building.type);
+    writeVarint(out, building.slot);
+}
+
+// A slot freed and reused within one broadcast keeps its key, so position counts as a change.
+static bool sameBuilding(const StateSnapshot::BuildingState& a, const StateSnapshot::BuildingState& b) {
+    return a.x == b.x && a.y == b.y && a.health == b.health && a.icon == b.icon && a.sizeX == b.sizeX && a.sizeY == b.sizeY && a.border == b.border;
+}
+
+static bool sameEnemy(const StateSnapshot::EnemyState& a, const StateSnapshot::EnemyState& b) {
+    return a.alive == b.alive && a.kind == b.kind && a.x == b.x && a.y == b.y;
+}
+
+void encodeState(const StateSnapshot* from, const StateSnapshot& to, string& out) {
+    static const StateSnapshot empty;
+    const StateSnapshot& previous = from ? *from : empty;
+    out.push_back(from ? 0 : STATE_RESET);
+    writeVarint(out, to.tick);
+
+    unsigned char scalars = 0;
+    if (!from || previous.playerX != to.playerX || previous.playerY != to.playerY) scalars |= SCALAR_PLAYER;
+    if (!from || previous.gold != to.gold || previous.elixir != to.elixir) scalars |= SCALAR_RESOURCES;
+    if (!from || previous.hasAnchor != to.hasAnchor || previous.anchorX != to.anchorX ||
+        previous.anchorY != to.anchorY) scalars |= SCALAR_ANCHOR;
+    if (!from || previous.gameOver != to.gameOver) scalars |= SCALAR_GAME_OVER;
+    out.push_back((char)scalars);
+    if (scalars & SCALAR_PLAYER) {
+        writeSigned(out, to.playerX);
+        writeSigned(out, to.playerY);
+    }
+    if (scalars & SCALAR_RESOURCES) {
+        writeSigned(out, to.gold);
+        writeSigned(out, to.elixir);
+    }
+    if (scalars & SCALAR_ANCHOR) {
+        out.push_back((char)to.hasAnchor);
+        writeSigned(out, to.anchorX);
+        writeSigned(out, to.anchorY);
+    }
+    if (scalars & SCALAR_GAME_OVER) out.push_back((char)to.gameOver);
+
+    // Both lists are in key order, so one merge pass finds what left and what is new or changed.
+    string removed, upserted;
+    size_t removedCount = 0, upsertedCount = 0;
+    size_t i = 0, j = 0;
+    while (i < previous.buildings.size() || j < to.buildings.size()) {
+        bool takeOld = j == to.buildings.size() ||
+                       (i < previous.buildings.size() && buildingBefore(previous.buildings[i], to.buildings[j]));
+        bool takeNew = i == previous.buildings.size() ||
+                       (j < to.buildings.size() && buildingBefore(to.buildings[j], previous.buildings[i]));
+        if (takeOld) {
+            writeBuildingKey(removed, previous.buildings[i++]);
+            ++removedCount;
+            continue;
+        }
+        const StateSnapshot::BuildingState& building = to.buildings[j++];
+        if (!takeNew) {
+            bool unchanged = sameBuilding(previous.buildings[i++], building);
+            if (unchanged) continue;
+        }
+        writeBuildingKey(upserted, building);
+        writeSigned(upserted, building.x);
+        writeSigned(upserted, building.y);
+        writeSigned(upserted, building.health);
+        upserted.push_back((char)building.icon);
+        upserted.push_back((char)building.sizeX);
+        upserted.push_back((char)building.sizeY);
+        upserted.push_back((char)building.border);
+        ++upsertedCount;
+    }
+    writeVarint(out, removedCount);
+    out += removed;
+    writeVarint(out, upsertedCount);
+    out += upserted;
+
+    string changed;
+    size_t changedCount = 0;
+    long long lastSlot = -1;
+    StateSnapshot::EnemyState none = { 0, 0, 0, 0 };
+    for (size_t slot = 0; slot < to.enemies.size(); ++slot) {
+        const StateSnapshot::EnemyState& before = slot < previous.enemies.size() ? previous.enemies[slot] : none;
+        const StateSnapshot::EnemyState& after = to.enemies[slot];
+        if (sameEnemy(before, after)) continue;
+        writeVarint(changed, slot - lastSlot - 1);
+        changed.push_back((char)(after.alive | (after.kind << 1)));
+        if (after.alive) {
+            writeSigned(changed, (long long)after.x - before.x);
+            writeSigned(changed, (long long)after.y - before.y);
+        }
+        lastSlot = slot;
+        ++changedCount;
+    }
+    writeVarint(out, to.enemies.size());
+    writeVarint(out, changedCount);
+    out += changed;
+}
+
+class MessageCursor {
+private:
+    const string& data;
+    size_t offset;
+    bool failed;
+
+public:
+    MessageCursor(const string& data) : data(data), offset(0), failed(false) {}
+
+    unsigned char byte() {
+        if (offset >= data.size()) {
+            failed = true;
+            return 0;
+        }
+        return data[offset++];
+    }
+
+    unsigned long long varint() {
+        unsigned long long value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            unsigned char next = byte();
+            value |= (unsigned long long)(next & 0x7f) << shift;
+            if (!(next & 0x80)) return value;
+        }
+        failed = true;
+        return 0;
+    }
+
+    long long signedVarint() {
+        unsigned long long value = varint();
+        return (long long)(value >> 1) ^ -(long long)(value & 1);
+    }
+
+    bool ok() const { return !failed; }
+    bool atEnd() const { return offset == data.size(); }
+};
+
+static StateSnapshot::BuildingState readBuildingKey(MessageCursor& in) {
+    StateSnapshot::BuildingState building = { 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+    building.type = in.byte();
+    building.slot = in.varint();
+    return building;
+}
+
+// Malformed input leaves the receiver with a partial update and a false return; the caller drops
+// the connection rather than draw from it.
+bool applyState(StateSnapshot& state, const string& message) {
+    MessageCursor in(message);
+    if (in.byte() & STATE_RESET) state = StateSnapshot();
+    state.tick = in.varint();
+
+    unsigned char scalars = in.byte();
+    if (scalars & SCALAR_PLAYER) {
+        state.playerX = in.signedVarint();
+        state.playerY = in.signedVarint();
+    }
+    if (scalars & SCALAR_RESOURCES) {
+        state.gold = in.signedVarint();
+        state.elixir = in.signedVarint();
+    }
+    if (scalars & SCALAR_ANCHOR) {
+        state.hasAnchor = in.byte() != 0;
+        state.anchorX = in.signedVarint();
+        state.anchorY = in.signedVarint();
+    }
+    if (scalars & SCALAR_GAME_OVER) state.gameOver = in.byte() != 0;
+
+    vector<StateSnapshot::BuildingState>& buildings = state.buildings;
+    unsigned long long removedCount = in.varint();
+    for (unsigned long long n = 0; n < removedCount && in.ok(); ++n) {
+        StateSnapshot::BuildingState key = readBuildingKey(in);
+        auto found = lower_bound(buildings.begin(), buildings.end(), key, buildingBefore);
+        if (found == buildings.end() || buildingBefore(key, *found)) return false;
+        buildings.erase(found);
+    }
+    unsigned long long upsertedCount = in.varint();
+    for (unsigned long long n = 0; n < upsertedCount && in.ok(); ++n) {
+        StateSnapshot::BuildingState building = readBuildingKey(in);
+        building.x = in.signedVarint();
+        building.y = in.signedVarint();
+        building.health = in.signedVarint();
+        building.icon = in.byte();
+        building.sizeX = in.byte();
+        building.sizeY = in.byte();
+        building.border = in.byte();
+        if (building.type > ELIXIR_COLLECTOR || building.icon >= GLYPH_COUNT) return false;
+        auto found = lower_bound(buildings.begin(), buildings.end(), building, buildingBefore);
+        if (found != buildings.end() && !buildingBefore(building, *found)) {
+            *found = building;
+        } else {
+            buildings.insert(found, building);
+        }
+    }
+
+    unsigned long long slotCount = in.varint();
+    if (!in.ok() || slotCount > MAX_ENEMY_SLOTS) return false;
+    StateSnapshot::EnemyState none = { 0, 0, 0, 0 };
+    state.enemies.resize(slotCount, none);
+    unsigned long long changedCount = in.varint();
+    unsigned long long slot = (unsigned long long)-1;
+    for (unsigned long long n = 0; n < changedCount && in.ok(); ++n) {
+        slot += in.varint() + 1;
+        if (slot >= slotCount) return false;
+        StateSnapshot::EnemyState& enemy = state.enemies[slot];
+        unsigned char flags = in.byte();
+        enemy.alive = flags & 1;
+        enemy.kind = flags >> 1;
+        if (enemy.kind >= ENEMY_KIND_COUNT) return false;
+        if (enemy.alive) {
+            enemy.x += in.signedVarint();
+            enemy.y += in.signedVarint();
+        } else {
+            enemy.x = enemy.y = 0;
+        }
+    }
+    return in.ok() && in.atEnd();
+}
+
+void appendMessage(string& out, char type, const string& body) {
+    writeVarint(out, body.size() + 1);
+    out.push_back(type);
+    out += body;
+}
+
+void encodeHello(int width, int height, string& out) {
+    writeVarint(out, width);
+    writeVarint(out, height);
+}
+
+bool decodeHello(const string& body, int& width, int& height) {
+    MessageCursor in(body);
+    unsigned long long w = in.varint(), h = in.varint();
+    if (!in.ok() || !in.atEnd() || w == 0 || h == 0 || w > 1 << 16 || h > 1 << 16) return false;
+    width = w;
+    height = h;
+    return true;
+}
+
+MessageReader::MessageReader() : offset(0), corrupt(false) {}
+
+void MessageReader::append(const char* data, size_t length) {
+    // Consumed bytes are dropped lazily, once they make up most of the buffer.
+    if (offset > 0 && offset * 2 >= buffer.size()) {
+        buffer.erase(0, offset);
+        offset = 0;
+    }
+    buffer.append(data, length);
+}
+
+// Waiting for more bytes only makes sense while the prefix could still be valid; an overlong
+// varint, an empty message or one past MAX_MESSAGE_LENGTH never will be.
+bool MessageReader::next(char& type, string& body) {
+    if (corrupt) return false;
+    unsigned long long length = 0;
+    size_t cursor = offset;
+    for (int bytes = 0; ; ++bytes) {
+        if (bytes == MAX_VARINT_BYTES) {
+            corrupt = true;
+            return false;
+        }
+        if (cursor >= buffer.size()) return false;
+        unsigned char byte = buffer[cursor++];
+        length |= (unsigned long long)(byte & 0x7f) << (bytes * 7);
+        if (!(byte & 0x80)) break;
+    }
+    if (length == 0 || length > MAX_MESSAGE_LENGTH) {
+        corrupt = true;
+        return false;
+    }
+    if (buffer.size() - cursor < length) return false;
+    type = buffer[cursor];
+    body.assign(buffer, cursor + 1, length - 1);
+    offset = cursor + length;
+    return true;
+}
+
+bool MessageReader::isCorrupt() const {
+    return corrupt;
+}
@@ -0,0 +1,72 @@
+#ifndef STATESTREAM_H
+#define STATESTREAM_H
+using namespace std;
+#include <string>
+#include <vector>
+
+class Board;
+
+// Everything a remote view draws, captured from the board once per broadcast. Buildings are
+// ordered by type, then registry slot, which is also the order a view draws them in. Enemies
+// are indexed by pool slot; a dead slot keeps no position.
+struct StateSnapshot {
+    struct BuildingState {
+        unsigned slot;
+        int x, y;
+        int health;
+        unsigned char type, icon, sizeX, sizeY, border;
+    };
+    struct EnemyState {
+        int x, y;
+        unsigned char kind, alive;
+    };
+
+    long long tick;
+    int playerX, playerY;
+    int gold, elixir;
+    int anchorX, anchorY;
+    bool hasAnchor, gameOver;
+    vector<BuildingState> buildings;
+    vector<EnemyState> enemies;
+
+    StateSnapshot();
+    size_t countBuildings(int type) const;
+    size_t countEnemies() const;
+    int getTownHallHealth() const;
+    unsigned long long checksum() const;
+    string describe() const;
+};
+
+void captureState(const Board& board, StateSnapshot& snapshot);
+
+// A state message carries only what changed between two snapshots: scalars that moved, buildings
+// that appeared, vanished or changed, and enemy slots that changed, with positions as offsets
+// from their previous value. Without a previous snapshot the message is a full state that
+// replaces whatever the receiver held.
+void encodeState(const StateSnapshot* from, const StateSnapshot& to, string& out);
+bool applyState(StateSnapshot& state, const string& message);
+
+// Messages travel as a varint length followed by that many bytes, the first being the type. A
+// server greets each viewer with the world size, then sends a full state and deltas after it.
+enum MessageType { MESSAGE_HELLO = 'H', MESSAGE_STATE = 'S' };
+
+void appendMessage(string& out, char type, const string& body);
+void encodeHello(int width, int height, string& out);
+bool decodeHello(const string& body, int& width, int& height);
+
+// Splits a byte stream into messages. A length prefix that cannot be valid marks the stream
+// corrupt: next returns false from then on and isCorrupt tells the caller to drop the connection.
+class MessageReader {
+private:
+    string buffer;
+    size_t offset;
+    bool corrupt;
+
+public:
+    MessageReader();
+    void append(const char* data, size_t length);
+    bool next(char& type, string& body);
+    bool isCorrupt() const;
+};
+
+#endif
@@ -0,0 +1,55 @@
+#include "TimerWheel.h"
+#include <algorithm>
+using namespace std;
+
+TimerWheel::TimerWheel(long long now) : now(now), pending(0) {}
+
+long long TimerWheel::getTick() const { return now; }
+size_t TimerWheel::size() const { return pending; }
+
+// A timer sits on the lowest level whose span still contains both now and its due tick.
+void TimerWheel::insert(const Timer& timer) {
+    for (int level = 0; level < LEVELS; ++level) {
+        int shift = SLOT_BITS * (level + 1);
+        if ((timer.due >> shift) == (now >> shift)) {
+            slots[level][(timer.due >> (SLOT_BITS * level)) & (SLOTS - 1)].push_back(timer);
+            return;
+        }
+    }
+    overflow.push_back(timer);
+}
+
+void TimerWheel::cascade(vector<Timer>& timers) {
+    cascading.swap(timers);
+    for (const Timer& timer : cascading) insert(timer);
+    cascading.clear();
+}
+
+// Timers due now or earlier fire on the next tick.
+void TimerWheel::schedule(long long due, int channel, int id) {
+    Timer timer = { due > now ? due : now + 1, channel, id };
+    insert(timer);
+    ++pending;
+}
+
+// Fired timers are appended in the order they were scheduled within their slot.
+void TimerWheel::advance(vector<Timer>& fired) {
+    ++now;
+    int boundary = 0;
+    while (boundary < LEVELS && (now & ((1LL << (SLOT_BITS * (boundary + 1))) - 1)) == 0) ++boundary;
+    // Higher levels go first so their timers can land in the lower slots cascaded after them.
+    if (boundary == LEVELS) cascade(overflow);
+    for (int level = min(boundary, LEVELS - 1); level >= 1; --level) {
+        cascade(slots[level][(now >> (SLOT_BITS * level)) & (SLOTS - 1)]);
+    }
+
+    // Swapping into an empty list hands its capacity back to the wheel instead of copying.
+    vector<Timer>& due = slots[0][now & (SLOTS - 1)];
+    pending -= due.size();
+    if (fired.empty()) {
+        fired.swap(due);
+    } else {
+        fired.insert(fired.end(), due.begin(), due.end());
+        due.clear();
+    }
+}
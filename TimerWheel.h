@@ -0,0 +1,43 @@
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+using namespace std;
+#include <cstddef>
+#include <vector>
+
+enum TimerChannel { TIMER_SPAWN, TIMER_ENEMY };
+
+// Hierarchical timer wheel: four levels of 64 slots cover 2^24 ticks, and anything further out
+// waits in an overflow list. A timer moves down a level each time its slot comes round, so a tick
+// only touches the timers that are due or about to be. Timers cannot be cancelled; owners check a
+// fired timer against their own state and ignore stale ones.
+class TimerWheel {
+public:
+    struct Timer {
+        long long due;
+        int channel;
+        int id;
+    };
+
+private:
+    static const int SLOT_BITS = 6;
+    static const int SLOTS = 1 << SLOT_BITS;
+    static const int LEVELS = 4;
+
+    long long now;
+    vector<Timer> slots[LEVELS][SLOTS];
+    vector<Timer> overflow;
+    vector<Timer> cascading;
+    size_t pending;
+
+    void insert(const Timer& timer);
+    void cascade(vector<Timer>& timers);
+
+public:
+    TimerWheel(long long now = 0);
+    long long getTick() const;
+    size_t size() const;
+    void schedule(long long due, int channel, int id);
+    void advance(vector<Timer>& fired);
+};
+
+#endif
@@ -3,7 +3,7 @@
 
 #include "Building.h"
 
-class TownHall : public Building {
+class TownHall : public TypedBuilding<TOWN_HALL> {
 public:
     TownHall(int x, int y);
 };
@@ -0,0 +1,55 @@
+#include "Tracer.h"
+#include <csignal>
+#include <cstdio>
+using namespace std;
+
+Tracer* Tracer::active = nullptr;
+
+static volatile sig_atomic_t flushRequested = 0;
+static atomic<int> nextThread(1);
+static thread_local int traceThread = 0;
+
+static void requestFlush(int) {
+    flushRequested = 1;
+}
+
+// SIGUSR1 only raises a flag: writing the file from the handler is not safe, so the game loop
+// picks it up through flushIfRequested at its next iteration.
+Tracer::Tracer(const string& path, size_t capacity)
+    : path(path), events(capacity), next(0), origin(GameClock::now()) {
+    signal(SIGUSR1, requestFlush);
+}
+
+void Tracer::record(const char* name, long long start, long long end) {
+    if (traceThread == 0) traceThread = nextThread.fetch_add(1);
+    Event& event = events[next.fetch_add(1, memory_order_relaxed) % events.size()];
+    event.name = name;
+    event.start = start;
+    event.duration = end - start;
+    event.thread = traceThread;
+}
+
+// Writes every span still in the ring, oldest first, as complete ("X") events in microseconds.
+// The game loop flushes between ticks, when no worker thread is recording.
+bool Tracer::flush() {
+    FILE* out = fopen(path.c_str(), "w");
+    if (!out) return false;
+
+    size_t recorded = next.load();
+    size_t count = min(recorded, events.size());
+    fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", out);
+    for (size_t i = 0; i < count; ++i) {
+        const Event& event = events[(recorded - count + i) % events.size()];
+        fprintf(out, "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                i == 0 ? "" : ",", event.name, event.thread,
+                (event.start - origin) / 1000.0, event.duration / 1000.0);
+    }
+    fputs("\n]}\n", out);
+    return fclose(out) == 0;
+}
+
+void Tracer::flushIfRequested() {
+    if (!flushRequested || !active) return;
+    flushRequested = 0;
+    active->flush();
+}
@@ -0,0 +1,50 @@
+#ifndef TRACER_H
+#define TRACER_H
+using namespace std;
+#include "GameClock.h"
+#include <atomic>
+#include <string>
+#include <vector>
+
+// Spans for a Chrome/Perfetto trace, kept in a ring preallocated up front so recording one is a
+// clock read and a slot write. When the ring wraps, the oldest spans are overwritten.
+class Tracer {
+private:
+    struct Event {
+        const char* name;
+        long long start;
+        long long duration;
+        int thread;
+    };
+
+    string path;
+    vector<Event> events;
+    atomic<size_t> next;
+    long long origin;
+
+public:
+    static Tracer* active;
+
+    Tracer(const string& path, size_t capacity);
+    void record(const char* name, long long start, long long end);
+    bool flush();
+    static void flushIfRequested();
+};
+
+// Records its scope as a span on the active tracer. With no tracer installed it does nothing,
+// not even read the clock.
+class TraceSpan {
+private:
+    Tracer* tracer;
+    const char* name;
+    long long start;
+
+public:
+    TraceSpan(const char* name)
+        : tracer(Tracer::active), name(name), start(tracer ? GameClock::now() : 0) {}
+    ~TraceSpan() {
+        if (tracer) tracer->record(name, start, GameClock::now());
+    }
+};
+
+#endif
@@ -3,9 +3,11 @@
 
 #include "Building.h"
 
-class Wall : public Building {
+class Wall : public TypedBuilding<WALL> {
 public:
     Wall(int x, int y);
 };
 
+static_assert(sizeof(Wall) == 8, "a wall holds only its position, health and type");
+
 #endif
@@ -0,0 +1,64 @@
+#include "WorkerPool.h"
+using namespace std;
+
+// The calling thread takes part in every run, so only threadCount - 1 helpers are started.
+WorkerPool::WorkerPool(int threadCount)
+    : jobCount(0), nextJob(0), busyWorkers(0), generation(0), stopping(false) {
+    for (int i = 1; i < threadCount; ++i) threads.emplace_back(&WorkerPool::workerLoop, this);
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        unique_lock<mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : threads) worker.join();
+}
+
+int WorkerPool::size() const {
+    return threads.size() + 1;
+}
+
+void WorkerPool::drain() {
+    int index;
+    while ((index = nextJob.fetch_add(1)) < jobCount) job(index);
+}
+
+void WorkerPool::workerLoop() {
+    long long seen = 0;
+    while (true) {
+        {
+            unique_lock<mutex> guard(lock);
+            wake.wait(guard, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+        }
+        drain();
+        {
+            unique_lock<mutex> guard(lock);
+            if (--busyWorkers == 0) finished.notify_one();
+        }
+    }
+}
+
+void WorkerPool::run(int jobs, const function<void(int)>& work) {
+    if (threads.empty() || jobs <= 1) {
+        for (int i = 0; i < jobs; ++i) work(i);
+        return;
+    }
+
+    {
+        unique_lock<mutex> guard(lock);
+        job = work;
+        jobCount = jobs;
+        nextJob = 0;
+        busyWorkers = threads.size();
+        ++generation;
+    }
+    wake.notify_all();
+    drain();
+
+    unique_lock<mutex> guard(lock);
+    finished.wait(guard, [&] { return busyWorkers == 0; });
+}
@@ -0,0 +1,34 @@
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+using namespace std;
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class WorkerPool {
+private:
+    vector<thread> threads;
+    mutex lock;
+    condition_variable wake;
+    condition_variable finished;
+    function<void(int)> job;
+    int jobCount;
+    atomic<int> nextJob;
+    int busyWorkers;
+    long long generation;
+    bool stopping;
+
+    void drain();
+    void workerLoop();
+
+public:
+    WorkerPool(int threadCount);
+    ~WorkerPool();
+    int size() const;
+    void run(int jobs, const function<void(int)>& work);
+};
+
+#endif
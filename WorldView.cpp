@@ -0,0 +1,139 @@
+#include "WorldView.h"
+#include "BuildingTraits.h"
+#include <algorithm>
+using namespace std;
+
+WorldView::WorldView(int worldWidth, int worldHeight, int viewWidth, int viewHeight)
+    : worldWidth(worldWidth), worldHeight(worldHeight),
+      viewWidth(viewWidth), viewHeight(viewHeight),
+      cameraX(0), cameraY(0),
+      screen(viewWidth, viewHeight) {}
+
+// The map fills the screen right of the side panel, inside the frame.
+int WorldView::getMapColumns() const { return viewWidth - margin - 2; }
+int WorldView::getMapRows() const { return viewHeight - 2; }
+
+// Keeps the focus centred until the view reaches a world edge. The camera stays on even columns
+// so two-column glyphs land on the same screen cells they were built on.
+void WorldView::begin(const Position& focus) {
+    cameraX = max(0, min(focus.x - getMapColumns() / 2, worldWidth - getMapColumns())) & ~1;
+    cameraY = max(0, min(focus.y - getMapRows() / 2, worldHeight - getMapRows()));
+    screen.clear();
+    renderTopBorder();
+    renderSides();
+    renderBottomBorder();
+}
+
+// The world cells the camera shows, inclusive. Glyphs are up to two columns wide, so the area
+// starts one column left of the view to take in anything that spills into it.
+void WorldView::getVisibleArea(int& left, int& top, int& right, int& bottom) const {
+    left = cameraX - 1;
+    top = cameraY;
+    right = cameraX + getMapColumns() - 1;
+    bottom = cameraY + getMapRows() - 1;
+}
+
+int WorldView::getPanelRows() const { return viewHeight - 2; }
+
+// Rows count from 1 at the top of the panel; text is cut at the divider.
+void WorldView::setPanelLine(int row, const string& text) {
+    if (row < 1 || row > viewHeight - 2) return;
+    screen.putText(2, row + 1, text.substr(0, margin - 1));
+}
+
+void WorldView::drawPanel(const PanelStatus& status) {
+    setPanelLine(1, "Gold = " + to_string(status.gold));
+    setPanelLine(2, "Elixir = " + to_string(status.elixir));
+    setPanelLine(3, "Walls = " + to_string(status.walls) + "/" + to_string(BuildingTraits<WALL>::maxInstances));
+    setPanelLine(4, "Gold Mines = " + to_string(status.goldMines) + "/" + to_string(BuildingTraits<GOLD_MINE>::maxInstances));
+    setPanelLine(5, "Elixir Generators = " + to_string(status.elixirCollectors) + "/" +
+                   to_string(BuildingTraits<ELIXIR_COLLECTOR>::maxInstances));
+    setPanelLine(6, "Town Hall HP = " + to_string(status.townHallHealth));
+    setPanelLine(7, "Enemies = " + to_string(status.enemies));
+    setPanelLine(8, "Position = " + to_string(status.player.x) + ", " + to_string(status.player.y));
+}
+
+void WorldView::put(int x, int y, GlyphId glyph) {
+    int screenX = margin + 2 + x - cameraX;
+    int screenY = 2 + y - cameraY;
+    int lastColumn = screenX + getGlyph(glyph).width - 1;
+    if (screenX < margin + 2 || lastColumn > viewWidth - 1 || screenY < 2 || screenY > viewHeight - 1) return;
+    screen.put(screenX, screenY, glyph);
+}
+
+void WorldView::drawBuilding(const Position& pos, int sizeX, int sizeY, bool border, GlyphId icon) {
+    int startX = pos.x;
+    int startY = pos.y;
+
+    // Icons are two columns wide, so a building one column left of the view can still show.
+    if (startX + max(sizeX, 2) <= cameraX || startX >= cameraX + getMapColumns() ||
+        startY + sizeY <= cameraY || startY >= cameraY + getMapRows()) return;
+
+    if (border) {
+        put(startX, startY, GLYPH_BOX_TOP_LEFT);
+        for (int i = 1; i < sizeX - 1; ++i) put(startX + i, startY, GLYPH_BOX_HORIZONTAL);
+        put(startX + sizeX - 1, startY, GLYPH_BOX_TOP_RIGHT);
+
+        for (int j = 1; j < sizeY - 1; ++j) {
+            put(startX, startY + j, GLYPH_BOX_VERTICAL);
+            for (int i = 1; i < sizeX - 1; ++i) {
+                if (i == sizeX/2 && j == sizeY/2) {
+                    put(startX + i, startY + j, icon);
+                    if (i < sizeX - 2) ++i;
+                } else {
+                    put(startX + i, startY + j, GLYPH_SPACE);
+                }
+            }
+            put(startX + sizeX - 1, startY + j, GLYPH_BOX_VERTICAL);
+        }
+
+        put(startX, startY + sizeY - 1, GLYPH_BOX_BOTTOM_LEFT);
+        for (int i = 1; i < sizeX - 1; ++i) put(startX + i, startY + sizeY - 1, GLYPH_BOX_HORIZONTAL);
+        put(startX + sizeX - 1, startY + sizeY - 1, GLYPH_BOX_BOTTOM_RIGHT);
+    } else {
+        put(startX, startY, icon);
+    }
+}
+
+void WorldView::showMessage(const string& text) {
+    screen.putText((viewWidth - text.length())/2, viewHeight/2, text);
+}
+
+void WorldView::present() {
+    screen.present();
+}
+
+size_t WorldView::getFrameBytes() const { return screen.getFrameBytes(); }
+int WorldView::getFrameWrites() const { return screen.getFrameWrites(); }
+
+void WorldView::invalidate() {
+    screen.invalidate();
+}
+
+void WorldView::setOutput(int fd) {
+    screen.setOutput(fd);
+}
+
+void WorldView::renderTopBorder() {
+    screen.put(1, 1, GLYPH_FRAME_TOP_LEFT);
+    for (int x = 1; x < viewWidth - 1; x++) {
+        screen.put(x + 1, 1, x == margin ? GLYPH_FRAME_TOP_TEE : GLYPH_FRAME_HORIZONTAL);
+    }
+    screen.put(viewWidth, 1, GLYPH_FRAME_TOP_RIGHT);
+}
+
+void WorldView::renderBottomBorder() {
+    screen.put(1, viewHeight, GLYPH_FRAME_BOTTOM_LEFT);
+    for (int x = 1; x < viewWidth - 1; x++) {
+        screen.put(x + 1, viewHeight, x == margin ? GLYPH_FRAME_BOTTOM_TEE : GLYPH_FRAME_HORIZONTAL);
+    }
+    screen.put(viewWidth, viewHeight, GLYPH_FRAME_BOTTOM_RIGHT);
+}
+
+void WorldView::renderSides() {
+    for (int y = 1; y < viewHeight - 1; y++) {
+        screen.put(1, y + 1, GLYPH_FRAME_VERTICAL);
+        screen.put(margin + 1, y + 1, GLYPH_FRAME_VERTICAL);
+        screen.put(viewWidth, y + 1, GLYPH_FRAME_VERTICAL);
+    }
+}
@@ -0,0 +1,54 @@
+#ifndef WORLDVIEW_H
+#define WORLDVIEW_H
+using namespace std;
+#include "Position.h"
+#include "Screen.h"
+#include <string>
+
+struct PanelStatus {
+    int gold, elixir;
+    size_t walls, goldMines, elixirCollectors;
+    int townHallHealth;
+    size_t enemies;
+    Position player;
+};
+
+// The framed layout every game view shows: a status panel on the left and, right of it, a camera
+// onto the world that follows a focus position. Drawing calls take world coordinates.
+class WorldView {
+private:
+    const int worldWidth;
+    const int worldHeight;
+    const int viewWidth;
+    const int viewHeight;
+    const int margin = 30;
+    int cameraX, cameraY;
+    Screen screen;
+
+    int getMapColumns() const;
+    int getMapRows() const;
+    void renderTopBorder();
+    void renderBottomBorder();
+    void renderSides();
+
+public:
+    // drawPanel fills rows 1 to PANEL_STATUS_ROWS; the rows below are free for other text.
+    static const int PANEL_STATUS_ROWS = 8;
+
+    WorldView(int worldWidth, int worldHeight, int viewWidth, int viewHeight);
+    void begin(const Position& focus);
+    void getVisibleArea(int& left, int& top, int& right, int& bottom) const;
+    int getPanelRows() const;
+    void setPanelLine(int row, const string& text);
+    void drawPanel(const PanelStatus& status);
+    void put(int x, int y, GlyphId glyph);
+    void drawBuilding(const Position& pos, int sizeX, int sizeY, bool border, GlyphId icon);
+    void showMessage(const string& text);
+    void present();
+    size_t getFrameBytes() const;
+    int getFrameWrites() const;
+    void invalidate();
+    void setOutput(int fd);
+};
+
+#endif
@@ -0,0 +1,257 @@
+// Sweeps the Board hot paths over board size, wall count and enemy count and prints one JSON document.
+// g++ -std=c++17 -O2 -pthread bench_board.cpp $(ls *.cpp | grep -v -e contour -e main.cpp -e '^bench') -o bench_board
+#include "Board.h"
+#include "EnemyPool.h"
+#include "FlowField.h"
+#include "GameClock.h"
+#include "GoldMine.h"
+#include "OccupancyGrid.h"
+#include "TownHall.h"
+#include "Wall.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+using namespace std;
+
+struct Scenario {
+    int width;
+    int height;
+    int walls;
+    int enemies;
+};
+
+struct Result {
+    long long iterations;
+    double nanosPerOp;
+};
+
+static double minSeconds = 0.05;
+static long long maxIterations = 1LL << 24;
+
+// Doubles the batch size until one batch runs for at least minSeconds.
+static Result measure(const function<void(long long)>& batch, long long iterationCap) {
+    long long cap = min(iterationCap, maxIterations);
+    long long iterations = 1;
+    while (true) {
+        long long start = GameClock::now();
+        batch(iterations);
+        long long elapsed = GameClock::now() - start;
+        if (elapsed >= minSeconds * 1e9 || iterations >= cap) {
+            Result result = { iterations, (double)elapsed / iterations };
+            return result;
+        }
+        iterations = min(iterations * 2, cap);
+    }
+}
+
+static bool firstRecord = true;
+static volatile size_t sinkValue;
+
+static void emit(const string& name, const Scenario& scenario, int actualWalls, const Result& result) {
+    cout << (firstRecord ? "\n" : ",\n");
+    firstRecord = false;
+    cout << "    {\"benchmark\": \"" << name << "\", \"width\": " << scenario.width
+         << ", \"height\": " << scenario.height << ", \"walls\": " << actualWalls
+         << ", \"enemies\": " << scenario.enemies << ", \"iterations\": " << result.iterations
+         << ", \"ns_per_op\": " << result.nanosPerOp << "}";
+}
+
+// Walls land on the even columns the player builds on; enemies enter at the battlefield's side edges the way spawnEnemy places them.
+static int populate(Board& board, const Scenario& scenario, mt19937& gen) {
+    uniform_int_distribution<> column(1, (scenario.width - 2) / 2);
+    uniform_int_distribution<> row(0, scenario.height - 1);
+    int placed = 0;
+    for (int attempt = 0; placed < scenario.walls && attempt < scenario.walls * 4; ++attempt) {
+        if (board.addWall(column(gen) * 2, row(gen))) ++placed;
+    }
+    uniform_int_distribution<> side(0, 1);
+    uniform_int_distribution<> fieldRow(board.getFieldTop(), board.getFieldBottom());
+    for (int i = 0; i < scenario.enemies; ++i) {
+        board.spawnEnemyAt(side(gen) ? board.getFieldLeft() : board.getFieldRight(), fieldRow(gen));
+    }
+    return placed;
+}
+
+// Few enough ticks that enemies entering at the edges cannot reach the town hall and end the game.
+static const int TICKS_PER_RUN = 24;
+
+// The simulation benchmarks advance the board, so they repeat short runs on freshly populated
+// boards until the timed ticks add up to minSeconds. tick runs one tick and returns the
+// nanoseconds it counts; building the boards is not timed.
+static Result measureRuns(const Scenario& scenario, int& walls, const function<long long(Board&)>& tick) {
+    long long iterations = 0, elapsed = 0;
+    while (elapsed < minSeconds * 1e9 && iterations < maxIterations) {
+        mt19937 gen(12345);
+        Board board(scenario.width, scenario.height);
+        board.setPerfHud(true);
+        walls = populate(board, scenario, gen);
+        for (int i = 0; i < TICKS_PER_RUN; ++i) elapsed += tick(board);
+        iterations += TICKS_PER_RUN;
+    }
+    Result result = { iterations, (double)elapsed / iterations };
+    return result;
+}
+
+static void benchBoard(const Scenario& scenario, int nullFd) {
+    mt19937 gen(12345);
+
+    int walls;
+    Result result = measureRuns(scenario, walls, [](Board& board) {
+        long long start = GameClock::now();
+        board.update();
+        return GameClock::now() - start;
+    });
+    emit("Board::update", scenario, walls, result);
+    // The enemy phase of the same ticks, read back from the board's own phase timer.
+    result = measureRuns(scenario, walls, [](Board& board) {
+        board.update();
+        return board.getPerfStats()->getLast(PERF_ENEMIES);
+    });
+    emit("Board::updateEnemies", scenario, walls, result);
+
+    Board board(scenario.width, scenario.height);
+    walls = populate(board, scenario, gen);
+
+    vector<Position> probes;
+    vector<GoldMine> probeMines;
+    for (int i = 0; i < 4096; ++i) {
+        probes.push_back(Position(uniform_int_distribution<>(0, scenario.width - 1)(gen),
+                                  uniform_int_distribution<>(0, scenario.height - 1)(gen)));
+        probeMines.push_back(GoldMine(probes.back().x, probes.back().y));
+    }
+    size_t sink = 0;
+    emit("Board::isPositionOccupied", scenario, walls, measure([&](long long n) {
+        for (long long i = 0; i < n; ++i) sink += board.isPositionOccupied(probes[i & 4095]);
+    }, maxIterations));
+    emit("Board::CanBuild", scenario, walls, measure([&](long long n) {
+        for (long long i = 0; i < n; ++i) sink += board.CanBuild(probeMines[i & 4095]);
+    }, maxIterations));
+
+    board.setOutput(nullFd);
+    board.render();
+    emit("Board::render", scenario, walls, measure([&](long long n) {
+        for (long long i = 0; i < n; ++i) board.render();
+    }, maxIterations));
+    emit("Board::render(full)", scenario, walls, measure([&](long long n) {
+        for (long long i = 0; i < n; ++i) {
+            board.invalidateScreen();
+            board.render();
+        }
+    }, maxIterations));
+    sinkValue = sink;
+}
+
+static void benchEnemyPool(const Scenario& scenario) {
+    mt19937 gen(777);
+    OccupancyGrid occupancy(scenario.width, scenario.height);
+    TownHall townhall(scenario.width / 2, scenario.height / 2);
+    occupancy.place(&townhall);
+
+    vector<unique_ptr<Wall> > walls;
+    uniform_int_distribution<> column(0, scenario.width - 1);
+    uniform_int_distribution<> row(0, scenario.height - 1);
+    for (int i = 0; i < scenario.walls * 4 && (int)walls.size() < scenario.walls; ++i) {
+        int x = column(gen), y = row(gen);
+        if (occupancy.at(x, y)) continue;
+        walls.emplace_back(new Wall(x, y));
+        occupancy.place(walls.back().get());
+    }
+
+    FlowField flowField(0, 0, scenario.width - 1, scenario.height - 1, getEnemyArchetype(GRUNT).damage);
+    flowField.rebuild(occupancy);
+
+    TimerWheel timers;
+    vector<TimerWheel::Timer> fired;
+    EnemyPool enemies(timers);
+    for (int i = 0; i < scenario.enemies; ++i) enemies.spawn(i % 2 ? 0 : scenario.width - 1, row(gen));
+
+    emit("EnemyPool::update", scenario, walls.size(), measure([&](long long n) {
+        for (long long i = 0; i < n; ++i) {
+            fired.clear();
+            timers.advance(fired);
+            enemies.update(fired, flowField, occupancy);
+        }
+    }, 24));
+}
+
+// The player stands on a gold mine placed before the walls go up, so every call finds it through
+// the same lookup the 'C' command uses. The board is not advanced, so only the lookup and the
+// collection itself are timed.
+static void benchCollect(const Scenario& scenario) {
+    mt19937 gen(12345);
+    Board board(scenario.width, scenario.height);
+    for (int i = 0; i < 6; ++i) board.tryMovePlayer('R');
+    if (!board.placeGoldMine()) return;
+    int walls = populate(board, scenario, gen);
+    emit("Board::collectResources", scenario, walls, measure([&](long long n) {
+        for (long long i = 0; i < n; ++i) board.collectResources();
+    }, maxIterations));
+}
+
+// Generators have no per-tick work any more; this measures deriving the amount and icon for every
+// generator at a tick and emptying the full ones, as the renderer and collectResources do.
+static void benchGenerators(int count) {
+    vector<GoldMine> mines;
+    mines.reserve(count);
+    for (int i = 0; i < count; ++i) mines.emplace_back(i * 7, 0, i % 20);
+    size_t sink = 0;
+    Result result = measure([&](long long n) {
+        for (long long i = 0; i < n; ++i) {
+            for (auto& mine : mines) {
+                sink += mine.getIconAt(i);
+                sink += mine.collect(i);
+            }
+        }
+    }, maxIterations);
+    sinkValue = sink;
+    result.nanosPerOp /= count;
+    cout << (firstRecord ? "\n" : ",\n");
+    firstRecord = false;
+    cout << "    {\"benchmark\": \"ResourceGenerator::collect\", \"generators\": " << count
+         << ", \"iterations\": " << result.iterations << ", \"ns_per_op\": " << result.nanosPerOp << "}";
+}
+
+int main(int argc, char* argv[]) {
+    vector<pair<int, int> > sizes = { {114, 31}, {512, 128}, {1024, 512}, {4096, 4096} };
+    vector<int> wallCounts = { 0, 100, 1000, 10000 };
+    vector<int> enemyCounts = { 10, 100, 1000, 10000, 100000 };
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--quick") == 0) {
+            sizes = { {114, 31}, {512, 128} };
+            wallCounts = { 0, 1000 };
+            enemyCounts = { 10, 1000, 100000 };
+            minSeconds = 0.01;
+        } else if (strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+            minSeconds = atof(argv[++i]);
+        } else {
+            cerr << "usage: " << argv[0] << " [--quick] [--min-time SECONDS]" << endl;
+            return 2;
+        }
+    }
+
+    int nullFd = open("/dev/null", O_WRONLY);
+    cout << "{\n  \"results\": [";
+    for (auto& size : sizes) {
+        for (int walls : wallCounts) {
+            Scenario collectScenario = { size.first, size.second, walls, 0 };
+            benchCollect(collectScenario);
+            for (int enemies : enemyCounts) {
+                Scenario scenario = { size.first, size.second, walls, enemies };
+                benchBoard(scenario, nullFd);
+                // The standalone pool runs its flow field over the whole map, which the Board never does for large worlds.
+                if (size.first * size.second <= 1024 * 512) benchEnemyPool(scenario);
+            }
+        }
+    }
+    for (int count : { 3, 100, 10000 }) benchGenerators(count);
+    cout << "\n  ]\n}" << endl;
+    close(nullFd);
+    return 0;
+}
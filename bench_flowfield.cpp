@@ -0,0 +1,106 @@
+// Compares FlowField::repair against FlowField::rebuild over a stream of random wall edits.
+// g++ -std=c++17 -O2 bench_flowfield.cpp FlowField.cpp OccupancyGrid.cpp BuildingRegistry.cpp Building.cpp Wall.cpp TownHall.cpp Position.cpp -o bench_flowfield
+#include "FlowField.h"
+#include "OccupancyGrid.h"
+#include "TownHall.h"
+#include "Wall.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+using namespace std;
+
+static bool sameDistances(const FlowField& a, const FlowField& b, int width, int height) {
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            if (a.getDistance(Position(x, y)) != b.getDistance(Position(x, y))) return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    int width = argc > 1 ? atoi(argv[1]) : 256;
+    int height = argc > 2 ? atoi(argv[2]) : 256;
+    int edits = argc > 3 ? atoi(argv[3]) : 1000;
+    unsigned seed = argc > 4 ? atoi(argv[4]) : 1;
+
+    OccupancyGrid occupancy(width, height);
+    TownHall townhall(width / 2 - 4, height / 2 - 2);
+    occupancy.place(&townhall);
+
+    FlowField incremental(0, 0, width - 1, height - 1, 10);
+    FlowField full(0, 0, width - 1, height - 1, 10);
+    incremental.rebuild(occupancy);
+    full.rebuild(occupancy);
+
+    vector<unique_ptr<Wall> > walls(width * height);
+    mt19937 gen(seed);
+    uniform_int_distribution<> xDis(0, width - 1);
+    uniform_int_distribution<> yDis(0, height - 1);
+    uniform_int_distribution<> coin(0, 1);
+    vector<int> wallCells;
+
+    typedef chrono::steady_clock Clock;
+    Clock::duration repairTime(0), rebuildTime(0);
+    int placed = 0, removed = 0, mismatches = 0;
+
+    for (int i = 0; i < edits; ++i) {
+        int x = xDis(gen), y = yDis(gen);
+        // Half of the edits knock down an existing wall so both cost increases and decreases are exercised.
+        if (!wallCells.empty() && coin(gen)) {
+            size_t pick = uniform_int_distribution<size_t>(0, wallCells.size() - 1)(gen);
+            x = wallCells[pick] % width;
+            y = wallCells[pick] / width;
+            wallCells[pick] = wallCells.back();
+            wallCells.pop_back();
+        }
+        const Building* building = occupancy.at(x, y);
+        if (building && building->getType() == TOWN_HALL) {
+            --i;
+            continue;
+        }
+
+        unique_ptr<Wall>& wall = walls[y * width + x];
+        if (wall) {
+            occupancy.remove(wall.get());
+            wall.reset();
+            for (size_t w = 0; w < wallCells.size(); ++w) {
+                if (wallCells[w] == y * width + x) {
+                    wallCells[w] = wallCells.back();
+                    wallCells.pop_back();
+                    break;
+                }
+            }
+            ++removed;
+        } else {
+            wall.reset(new Wall(x, y));
+            occupancy.place(wall.get());
+            wallCells.push_back(y * width + x);
+            ++placed;
+        }
+
+        Clock::time_point start = Clock::now();
+        incremental.repair(occupancy, x, y, 1, 1);
+        Clock::time_point middle = Clock::now();
+        full.rebuild(occupancy);
+        Clock::time_point end = Clock::now();
+        repairTime += middle - start;
+        rebuildTime += end - middle;
+
+        if (i % 100 == 0 && !sameDistances(incremental, full, width, height)) ++mismatches;
+    }
+    if (!sameDistances(incremental, full, width, height)) ++mismatches;
+
+    double repairMicros = chrono::duration<double, micro>(repairTime).count() / edits;
+    double rebuildMicros = chrono::duration<double, micro>(rebuildTime).count() / edits;
+    cout << "board " << width << "x" << height << ", " << edits << " edits ("
+         << placed << " placed, " << removed << " removed)" << endl;
+    cout << "repair:  " << repairMicros << " us/edit" << endl;
+    cout << "rebuild: " << rebuildMicros << " us/edit" << endl;
+    cout << "speedup: " << rebuildMicros / repairMicros << "x" << endl;
+    cout << "distance mismatches: " << mismatches << endl;
+    return mismatches == 0 ? 0 : 1;
+}
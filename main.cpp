@@ -1,41 +1,198 @@
 #include "Board.h"
+#include "Client.h"
+#include "GameClock.h"
+#include "Headless.h"
 #include "InputManager.h"
-#include <unistd.h>  
+#include "Recording.h"
+#include "SaveFile.h"
+#include "Server.h"
+#include "Tracer.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <memory>
+#include <random>
+#include <sys/ioctl.h>
+#include <unistd.h>
 using namespace std;
-int main() {
-    cout << "\033[?25l";
-    Board board;
+
+static const int TICKS_PER_SECOND = 10;
+// 256K spans of 32 bytes: minutes of interactive play, or a few thousand headless ticks.
+static const size_t TRACE_CAPACITY = 1 << 18;
+
+static bool parseWorldSize(const char* text, int& width, int& height) {
+    int w, h;
+    if (sscanf(text, "%dx%d", &w, &h) != 2) return false;
+    if (w < MIN_WORLD_WIDTH || h < MIN_WORLD_HEIGHT || w > MAX_WORLD_SIZE || h > MAX_WORLD_SIZE) return false;
+    width = w;
+    height = h;
+    return true;
+}
+
+// The view fills the terminal, falling back to the classic 147x33 layout when its size is unknown.
+static void getViewSize(int& columns, int& rows) {
+    columns = 147;
+    rows = 33;
+    winsize size;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_col >= 60 && size.ws_row >= 12) {
+        columns = size.ws_col;
+        rows = size.ws_row - 1;
+    }
+}
+
+// 'S' writes savePath and is not recorded: a save changes nothing a replay would need to reproduce.
+static int runInteractive(int width, int height, unsigned seed, const string& recordPath,
+                          const string& savePath, const string& loadPath, bool showPerf) {
+    int columns, rows;
+    getViewSize(columns, rows);
+    unique_ptr<Board> loaded;
+    if (loadPath.empty()) {
+        loaded.reset(new Board(width, height, seed, columns, rows));
+    } else if (!(loaded = loadBoard(loadPath, columns, rows))) {
+        cerr << "cannot load save " << loadPath << endl;
+        return 1;
+    }
+    Board& board = *loaded;
+    board.setPerfHud(showPerf);
+    unique_ptr<InputRecorder> recorder;
+    if (!recordPath.empty()) {
+        recorder.reset(new InputRecorder(recordPath, seed, board.getWidth(), board.getHeight()));
+        if (!recorder->isOpen()) {
+            cerr << "cannot write recording " << recordPath << endl;
+            return 1;
+        }
+    }
+
+    cout << "\033[?25l" << flush;
     InputManager inputManager;
+    GameClock clock(TICKS_PER_SECOND);
+    bool running = true;
+    bool saveFailed = false;
+
+    board.render();
+    while (running && !board.isGameOver()) {
+        char input;
+        while (running && inputManager.poll(input)) {
+            if (input == 'Q') {
+                running = false;
+            } else if (input == 'S' && !savePath.empty()) {
+                // The bell is the only signal the game screen can give; the error is repeated on exit.
+                if (!saveBoard(board, savePath)) {
+                    saveFailed = true;
+                    cout << '\a' << flush;
+                }
+            } else if (board.applyCommand(input) && recorder) {
+                recorder->record(board.getTick(), input);
+            }
+        }
+
+        while (running && clock.due()) board.update();
 
-    while (true) {
         board.render();
-        char input = inputManager.getInput();
-
-        switch(input) {
-            case 'U': case 'D': case 'L': case 'R':
-                board.tryMovePlayer(input);
-                break;
-            case 'W':
-                board.placeWall();
-                break;
-            case 'M':
-                board.placeGoldMine();
-                break;
-            case 'E':
-                board.placeElixirCollector();
-                break;
-            case 'C':
-                board.collectResources();
-                break;
-            case 'Q':
-                cout << "\033[?25h";
-                return 0;
+        Tracer::flushIfRequested();
+        if (running) {
+            TraceSpan waitSpan("wait for input");
+            inputManager.waitForInput(clock.nanosUntilDeadline());
         }
+    }
+    if (recorder) recorder->finish(board.getTick(), board.checksum());
 
-        board.update();
-        usleep(100000);
+    cout << "\033[" << rows + 1 << ";1H\033[?25h" << flush;
+    cerr << clock.getTicks() << " ticks, jitter mean " << clock.getMeanJitterMicros()
+         << " us, max " << clock.getMaxJitterMicros() << " us" << endl;
+    if (saveFailed) {
+        cerr << "cannot write save " << savePath << endl;
+        return 1;
     }
-    cout << "\033[?25h";
     return 0;
 }
+
+static int finishTrace(int status) {
+    if (Tracer::active && !Tracer::active->flush()) {
+        cerr << "cannot write trace" << endl;
+        return status == 0 ? 1 : status;
+    }
+    return status;
+}
+
+int main(int argc, char* argv[]) {
+    bool headless = false;
+    bool seeded = false;
+    bool showPerf = false;
+    string recordPath, replayPath, servePath, connectPath, tracePath;
+    int ticksPerSecond = TICKS_PER_SECOND;
+    HeadlessOptions options = { 1000000, 1, "", 0, 114, 31, "", "" };
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--headless") == 0) {
+            headless = true;
+        } else if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) {
+            options.ticks = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "--world") == 0 && i + 1 < argc) {
+            if (!parseWorldSize(argv[++i], options.width, options.height)) {
+                cerr << "world size must be WxH between " << MIN_WORLD_WIDTH << "x" << MIN_WORLD_HEIGHT
+                     << " and " << MAX_WORLD_SIZE << "x" << MAX_WORLD_SIZE << endl;
+                return 2;
+            }
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            options.seed = strtoul(argv[++i], nullptr, 10);
+            seeded = true;
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            options.threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--script") == 0 && i + 1 < argc) {
+            options.scriptPath = argv[++i];
+        } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else if (strcmp(argv[i], "--save") == 0 && i + 1 < argc) {
+            options.savePath = argv[++i];
+        } else if (strcmp(argv[i], "--load") == 0 && i + 1 < argc) {
+            options.loadPath = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replayPath = argv[++i];
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            tracePath = argv[++i];
+        } else if (strcmp(argv[i], "--perf") == 0) {
+            showPerf = true;
+        } else if (strcmp(argv[i], "--serve") == 0 && i + 1 < argc) {
+            servePath = argv[++i];
+        } else if (strcmp(argv[i], "--connect") == 0 && i + 1 < argc) {
+            connectPath = argv[++i];
+        } else if (strcmp(argv[i], "--rate") == 0 && i + 1 < argc) {
+            ticksPerSecond = max(1, atoi(argv[++i]));
+        } else {
+            cerr << "usage: " << argv[0] << " [--world WxH] [--seed S] [--record FILE] [--save FILE] [--load FILE] [--perf] [--trace FILE]" << endl
+                 << "       " << argv[0] << " --headless [--world WxH] [--ticks N] [--seed S] [--threads N] [--script FILE] [--save FILE] [--load FILE] [--trace FILE]" << endl
+                 << "       " << argv[0] << " --replay FILE [--trace FILE]" << endl
+                 << "       " << argv[0] << " --serve SOCKET [--world WxH] [--ticks N] [--seed S] [--threads N] [--rate N] [--load FILE] [--trace FILE]" << endl
+                 << "       " << argv[0] << " --connect SOCKET [--headless [--script FILE]]" << endl;
+            return 2;
+        }
+    }
+    // A recording replays from a fresh board, so it cannot start from a save.
+    if (!recordPath.empty() && !options.loadPath.empty()) {
+        cerr << "--record cannot be combined with --load" << endl;
+        return 2;
+    }
+    // The trace is written when the run ends, and also whenever SIGUSR1 arrives during it.
+    unique_ptr<Tracer> tracer;
+    if (!tracePath.empty()) {
+        tracer.reset(new Tracer(tracePath, TRACE_CAPACITY));
+        Tracer::active = tracer.get();
+    }
+    if (!replayPath.empty()) return finishTrace(runReplay(replayPath));
+    if (!servePath.empty()) {
+        ServerOptions server = { servePath, options.ticks, ticksPerSecond, options.seed, options.threads,
+                                 options.width, options.height, options.loadPath };
+        return finishTrace(runServer(server));
+    }
+    if (!connectPath.empty()) {
+        int columns, rows;
+        getViewSize(columns, rows);
+        ClientOptions client = { connectPath, headless, options.scriptPath, columns, rows };
+        return runClient(client);
+    }
+    if (headless) return finishTrace(runHeadless(options));
+    return finishTrace(runInteractive(options.width, options.height, seeded ? options.seed : random_device()(),
+                                      recordPath, options.savePath, options.loadPath, showPerf));
+}